@@ -1,24 +1,32 @@
 #ifndef COMMAND_H
 #define COMMAND_H
 
-#include <string>
+#include <string_view>
 #include <iostream>
 
 class Command {
 public:
-    std::string command;
-    std::string description;
+    // Both views point into the CommandCatalog's string arena (or the
+    // snapshot it loaded), so a Command is small and copying one never
+    // allocates.
+    std::string_view command;
+    std::string_view description;
     int points;
+    // Assigned by the CommandCatalog when the command is added and never
+    // reused by it, so it identifies the command across catalog versions.
+    // 0 for a command that is not in a catalog.
+    int id;
 
-    Command() : command(""), description(""), points(0) {}
+    Command() : command(), description(), points(0), id(0) {}
 
     
-    Command(const std::string& cmd, const std::string& desc, int pts)
-        : command(cmd), description(desc), points(pts) {}
+    Command(std::string_view cmd, std::string_view desc, int pts)
+        : command(cmd), description(desc), points(pts), id(0) {}
 
     
     Command(const Command& other) 
-        : command(other.command), description(other.description), points(other.points) {}
+        : command(other.command), description(other.description), points(other.points),
+          id(other.id) {}
 
     
     Command& operator=(const Command& other) {
@@ -26,6 +34,7 @@ public:
             command = other.command;
             description = other.description;
             points = other.points;
+            id = other.id;
         }
         return *this;
     }
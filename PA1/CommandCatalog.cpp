@@ -0,0 +1,310 @@
+#include "CommandCatalog.h"
+#include "CsvReader.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cmath>
+
+CommandCatalog::CommandCatalog()
+    : text(std::make_shared<TextStore>()), liveTextBytes(0), deadTextBytes(0),
+      indexBuilt(true), searchBuilt(false), changed(false), nextId(1),
+      base(std::make_shared<const std::vector<Command> >()), needsRebase(false),
+      published(std::unique_ptr<Version>(new Version())) {
+    commands.setRelocationHandler([this](const Command& cmd, Node<Command>* chunk) {
+        if (indexBuilt) {
+            commandIndex[cmd.command] = chunk;
+        }
+    });
+}
+
+// Maps the file and tokenizes it in one pass. Names and descriptions are
+// copied once, straight from the mapping into the arena.
+bool CommandCatalog::loadCsv(const std::string& path) {
+    MappedFile file;
+    if (!file.open(path, MappedFile::READ_ONCE)) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(writeLock);
+        std::string_view csv = file.contents();
+        nameIndexLocked().reserve(commands.getSize() + std::count(csv.begin(), csv.end(), '\n'));
+
+        CsvReader reader(csv);
+        std::vector<std::string_view> fields;
+        int points;
+        while (reader.next(fields)) {
+            if (fields.size() >= 3 && CsvReader::toInt(fields[2], points)) {
+                addLocked(fields[0], fields[1], points);
+            }
+        }
+    }
+    publish();
+    return true;
+}
+
+void CommandCatalog::loadSnapshot(std::unique_ptr<Snapshot> source) {
+    {
+        std::lock_guard<std::mutex> lock(writeLock);
+        int count = source->getCommandCount();
+        if (commands.isEmpty()) {
+            indexBuilt = false;
+            for (int i = 0; i < count; i++) {
+                insertLocked(source->commandAt(i));
+            }
+        } else {
+            std::unordered_map<std::string_view, Node<Command>*>& index = nameIndexLocked();
+            index.reserve(commands.getSize() + count);
+            for (int i = 0; i < count; i++) {
+                Command cmd = source->commandAt(i);
+                if (index.count(cmd.command) == 0) {
+                    insertLocked(cmd);
+                }
+            }
+        }
+        text->snapshots.push_back(std::move(source));
+    }
+    publish();
+}
+
+bool CommandCatalog::add(std::string_view command, std::string_view description, int points) {
+    std::lock_guard<std::mutex> lock(writeLock);
+    return addLocked(command, description, points);
+}
+
+// Appends a command with its text copied into the arena. Returns false
+// (and leaves the catalog unchanged) if the name is already present.
+bool CommandCatalog::addLocked(std::string_view command, std::string_view description, int points) {
+    if (nameIndexLocked().count(command) != 0) {
+        return false;
+    }
+    insertLocked(Command(text->arena.store(command), text->arena.store(description), points));
+    return true;
+}
+
+// Appends a command whose text the current TextStore keeps alive under the
+// next id, and records its chunk in the name index.
+void CommandCatalog::insertLocked(const Command& source) {
+    Command cmd(source);
+    cmd.id = nextId++;
+    commands.insertBack(cmd);
+    liveTextBytes += cmd.command.size() + cmd.description.size();
+    if (indexBuilt) {
+        commandIndex.emplace(cmd.command, commands.backChunk());
+    }
+    if (searchBuilt) {
+        search.add(cmd);
+    }
+    recordAddedLocked(cmd);
+    changed = true;
+}
+
+bool CommandCatalog::remove(std::string_view command) {
+    std::lock_guard<std::mutex> lock(writeLock);
+    std::unordered_map<std::string_view, Node<Command>*>& index = nameIndexLocked();
+    std::unordered_map<std::string_view, Node<Command>*>::iterator entry = index.find(command);
+    if (entry == index.end()) {
+        return false;
+    }
+    Node<Command>* chunk = entry->second;
+    int id = 0;
+    std::size_t textBytes = 0;
+    for (int i = 0; i < chunk->count; i++) {
+        if (chunk->at(i).command == command) {
+            id = chunk->at(i).id;
+            textBytes = chunk->at(i).command.size() + chunk->at(i).description.size();
+            break;
+        }
+    }
+    if (!commands.removeFromChunk(chunk, Command(command, std::string_view(), 0))) {
+        return false;
+    }
+    index.erase(entry);
+    if (searchBuilt) {
+        search.remove(command);
+    }
+    recordRemovedLocked(id);
+    liveTextBytes -= textBytes;
+    deadTextBytes += textBytes;
+    changed = true;
+    return true;
+}
+
+bool CommandCatalog::contains(std::string_view command) const {
+    std::lock_guard<std::mutex> lock(writeLock);
+    return nameIndexLocked().count(command) != 0;
+}
+
+int CommandCatalog::getSize() const {
+    std::lock_guard<std::mutex> lock(writeLock);
+    return commands.getSize();
+}
+
+std::vector<Command> CommandCatalog::findSubstring(std::string_view text, int limit) const {
+    std::lock_guard<std::mutex> lock(writeLock);
+    return searchIndexLocked().findSubstring(text, limit);
+}
+
+std::vector<Command> CommandCatalog::suggest(std::string_view name, int maxDistance, int limit) const {
+    std::lock_guard<std::mutex> lock(writeLock);
+    return searchIndexLocked().suggest(name, maxDistance, limit);
+}
+
+std::unordered_map<std::string_view, Node<Command>*>& CommandCatalog::nameIndexLocked() const {
+    if (!indexBuilt) {
+        commandIndex.reserve(commands.getSize());
+        for (Node<Command>* chunk = commands.frontChunk(); chunk != nullptr; chunk = chunk->next) {
+            for (int i = 0; i < chunk->count; i++) {
+                commandIndex.emplace(chunk->at(i).command, chunk);
+            }
+        }
+        indexBuilt = true;
+    }
+    return commandIndex;
+}
+
+const CommandSearch& CommandCatalog::searchIndexLocked() const {
+    if (!searchBuilt) {
+        for (const Command& cmd : commands) {
+            search.add(cmd);
+        }
+        searchBuilt = true;
+    }
+    return search;
+}
+
+// Changes since the base that are still worth carrying in every Version:
+// about sqrt(n), which balances copying them on each publish against
+// copying all n commands for a new base.
+int CommandCatalog::pendingLimitLocked() const {
+    int limit = static_cast<int>(std::sqrt(commands.getSize()));
+    return limit > MIN_PENDING_CHANGES ? limit : MIN_PENDING_CHANGES;
+}
+
+void CommandCatalog::recordAddedLocked(const Command& cmd) {
+    if (needsRebase) {
+        return;
+    }
+    addedSinceBase.push_back(cmd);
+    if (static_cast<int>(addedSinceBase.size() + removedFromBase.size()) > pendingLimitLocked()) {
+        needsRebase = true;
+    }
+}
+
+// Commands sit in id order both in the base and among the additions, so the
+// removed command is found by binary search.
+void CommandCatalog::recordRemovedLocked(int id) {
+    if (needsRebase) {
+        return;
+    }
+    auto byId = [](const Command& cmd, int value) {
+        return cmd.id < value;
+    };
+    std::vector<Command>::iterator added =
+        std::lower_bound(addedSinceBase.begin(), addedSinceBase.end(), id, byId);
+    if (added != addedSinceBase.end() && added->id == id) {
+        addedSinceBase.erase(added);
+        return;
+    }
+    int position = static_cast<int>(std::lower_bound(base->begin(), base->end(), id, byId) - base->begin());
+    removedFromBase.insert(std::upper_bound(removedFromBase.begin(), removedFromBase.end(), position),
+                           position);
+    if (static_cast<int>(addedSinceBase.size() + removedFromBase.size()) > pendingLimitLocked()) {
+        needsRebase = true;
+    }
+}
+
+// Copies the whole catalog into a new shared base and forgets the changes
+// recorded against the old one.
+void CommandCatalog::rebaseLocked() {
+    std::shared_ptr<std::vector<Command> > next = std::make_shared<std::vector<Command> >();
+    next->reserve(commands.getSize());
+    for (const Command& cmd : commands) {
+        next->push_back(cmd);
+    }
+    base = std::move(next);
+    removedFromBase.clear();
+    addedSinceBase.clear();
+    needsRebase = false;
+}
+
+// Copies the text of the current commands into a fresh TextStore and points
+// them at the copies. Everything else viewing the old text is rebuilt: the
+// name index and search index on next use, and the base right away. The old
+// store lives on in the Versions that still use it.
+void CommandCatalog::repackTextLocked() {
+    std::shared_ptr<TextStore> packed = std::make_shared<TextStore>();
+    for (Command& cmd : commands) {
+        cmd.command = packed->arena.store(cmd.command);
+        cmd.description = packed->arena.store(cmd.description);
+    }
+    text = std::move(packed);
+    deadTextBytes = 0;
+
+    commandIndex.clear();
+    indexBuilt = false;
+    search.clear();
+    searchBuilt = false;
+    needsRebase = true;
+}
+
+// Makes a new Version from the shared base and the changes since, and
+// swaps it in. Readers holding the previous Version keep using it until
+// they let go.
+void CommandCatalog::publish() {
+    std::lock_guard<std::mutex> lock(writeLock);
+    if (!changed) {
+        return;
+    }
+    if (deadTextBytes >= MIN_WASTED_TEXT_BYTES && deadTextBytes > liveTextBytes) {
+        repackTextLocked();
+    }
+    if (needsRebase) {
+        rebaseLocked();
+    }
+    std::unique_ptr<Version> next(new Version());
+    next->text = text;
+    next->base = base;
+    next->added = addedSinceBase;
+    next->removedShifted.reserve(removedFromBase.size());
+    for (std::size_t j = 0; j < removedFromBase.size(); j++) {
+        next->removedShifted.push_back(removedFromBase[j] - static_cast<int>(j));
+    }
+    published.publish(std::move(next));
+    changed = false;
+}
+
+CommandCatalog::ReadGuard CommandCatalog::read() const {
+    return published.read();
+}
+
+CommandCatalog::Version::Version() : base(std::make_shared<const std::vector<Command> >()) {}
+
+int CommandCatalog::Version::getSize() const {
+    return static_cast<int>(base->size() - removedShifted.size() + added.size());
+}
+
+bool CommandCatalog::Version::isEmpty() const {
+    return getSize() == 0;
+}
+
+const Command& CommandCatalog::Version::at(int index) const {
+    int liveInBase = static_cast<int>(base->size() - removedShifted.size());
+    if (index >= liveInBase) {
+        return added[index - liveInBase];
+    }
+    int skipped = static_cast<int>(
+        std::upper_bound(removedShifted.begin(), removedShifted.end(), index) - removedShifted.begin());
+    return (*base)[index + skipped];
+}
+
+CommandCatalog::Version::const_iterator CommandCatalog::Version::begin() const {
+    return const_iterator(this, 0);
+}
+
+CommandCatalog::Version::const_iterator CommandCatalog::Version::end() const {
+    return const_iterator(this, getSize());
+}
+
+CommandCatalog::TextRef CommandCatalog::Version::getText() const {
+    return text;
+}
@@ -0,0 +1,194 @@
+#ifndef COMMAND_CATALOG_H
+#define COMMAND_CATALOG_H
+
+#include "List.h"
+#include "Command.h"
+#include "CommandSearch.h"
+#include "EpochPtr.h"
+#include "Snapshot.h"
+#include "StringArena.h"
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// The command database: an unrolled List<Command> plus the auxiliary
+// indexes that keep admin operations and question generation O(1).
+//
+// Readers never see the List itself. Writers change it under a lock and
+// then publish() an immutable Version, which readers reach through read()
+// without taking any lock. A Version stays valid for as long as a reader's
+// guard holds it; old versions are freed once no reader can still see
+// them. Every command added gets the next Command::id, so ids identify a
+// command across versions; positions within a Version do not.
+//
+// Publishing does not copy the whole catalog. Versions share one immutable
+// base copy and each carries only the changes made since that base was
+// taken. Once those changes outgrow the square root of the catalog size, the
+// next publish() takes a fresh base. A publish therefore copies O(sqrt n)
+// commands, amortized, instead of n.
+//
+// Text stays in the arena after its command is removed. Once removed text
+// outweighs live text (and MIN_WASTED_TEXT_BYTES), publish() copies the
+// live text into a fresh arena first. The old arena, and any snapshot
+// mapping, is freed when the last Version or TextRef using it goes away,
+// so memory stays within about twice the live text.
+class CommandCatalog {
+public:
+    // Fewest changes since the base that make publish() take a new base.
+    static const int MIN_PENDING_CHANGES = 64;
+    // Fewest bytes of removed text that make publish() repack the text.
+    static const std::size_t MIN_WASTED_TEXT_BYTES = 64 * 1024;
+
+private:
+    // Storage for command text: the arena, plus any snapshots whose
+    // mapping commands view directly.
+    struct TextStore {
+        StringArena arena;
+        std::vector<std::unique_ptr<Snapshot> > snapshots;
+    };
+
+public:
+    // Keeps the text of one Version's commands alive. Copies of those
+    // Commands are valid for as long as a TextRef from the Version is held.
+    typedef std::shared_ptr<const TextStore> TextRef;
+
+    class Version {
+    public:
+        // Forward iterator over the commands in catalog order.
+        class const_iterator {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef Command value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const Command* pointer;
+            typedef const Command& reference;
+
+            const_iterator() : version(nullptr), index(0) {}
+
+            reference operator*() const { return version->at(index); }
+            pointer operator->() const { return &version->at(index); }
+            const_iterator& operator++() { ++index; return *this; }
+            const_iterator operator++(int) { const_iterator old = *this; ++index; return old; }
+            bool operator==(const const_iterator& other) const { return index == other.index; }
+            bool operator!=(const const_iterator& other) const { return index != other.index; }
+
+        private:
+            friend class Version;
+            const Version* version;
+            int index;
+
+            const_iterator(const Version* version, int index) : version(version), index(index) {}
+        };
+
+        Version();
+
+        int getSize() const;
+        bool isEmpty() const;
+        // The command at position index, 0 <= index < getSize(). O(log of
+        // the number of commands removed since the base was taken).
+        const Command& at(int index) const;
+
+        const_iterator begin() const;
+        const_iterator end() const;
+
+        // Holds this Version's text for copies of its commands that must
+        // outlive the read guard.
+        TextRef getText() const;
+
+    private:
+        friend class CommandCatalog;
+        TextRef text;
+        // The catalog as of the last rebase, shared by every Version since.
+        std::shared_ptr<const std::vector<Command> > base;
+        // For each base position removed since, in ascending order, that
+        // position minus the number of removed positions before it. Live
+        // index i then sits at base position i + (entries <= i).
+        std::vector<int> removedShifted;
+        // Commands added since the base was taken, in catalog order.
+        std::vector<Command> added;
+    };
+
+    typedef EpochPtr<Version>::Guard ReadGuard;
+
+private:
+    // Serializes writers; readers never take it.
+    mutable std::mutex writeLock;
+    // Text of the current commands, shared with the Versions that view it.
+    std::shared_ptr<TextStore> text;
+    // Bytes of name and description text held by the current commands, and
+    // by commands removed since the text was last packed.
+    std::size_t liveTextBytes;
+    std::size_t deadTextBytes;
+    List<Command> commands;
+    // Command name -> chunk of `commands` holding it. Keys view the
+    // commands' text. Kept in sync through List's relocation handler while
+    // built; a catalog loaded from a snapshot builds it on first use.
+    mutable std::unordered_map<std::string_view, Node<Command>*> commandIndex;
+    mutable bool indexBuilt;
+    // Trigram index for admin search. Built by the first search, so startup
+    // does not pay for it, then updated with every add and remove.
+    mutable CommandSearch search;
+    mutable bool searchBuilt;
+    // Set by add and remove until the next publish().
+    bool changed;
+    // Id for the next command added.
+    int nextId;
+    // Writer-side copy of what the next Version is made of: the shared
+    // base, the base positions removed since (ascending) and the commands
+    // added since. Catalog order is id order, so both are found by id.
+    std::shared_ptr<const std::vector<Command> > base;
+    std::vector<int> removedFromBase;
+    std::vector<Command> addedSinceBase;
+    // Set once the changes since the base outgrow pendingLimitLocked(); the
+    // next publish() then takes a new base and the changes are not recorded.
+    bool needsRebase;
+    EpochPtr<Version> published;
+
+    bool addLocked(std::string_view command, std::string_view description, int points);
+    void insertLocked(const Command& source);
+    std::unordered_map<std::string_view, Node<Command>*>& nameIndexLocked() const;
+    int pendingLimitLocked() const;
+    void recordAddedLocked(const Command& cmd);
+    void recordRemovedLocked(int id);
+    void rebaseLocked();
+    void repackTextLocked();
+    const CommandSearch& searchIndexLocked() const;
+
+public:
+    CommandCatalog();
+
+    CommandCatalog(const CommandCatalog&) = delete;
+    CommandCatalog& operator=(const CommandCatalog&) = delete;
+
+    // Adds every well-formed `command,"description",points` row of a CSV
+    // file and publishes the result. Returns false if the file cannot be
+    // opened.
+    bool loadCsv(const std::string& path);
+    // Adds the commands of an open snapshot without copying their text,
+    // keeps the snapshot alive while they use it, and publishes the
+    // result. Into an empty catalog this skips the name index, since a
+    // snapshot's names are already unique.
+    void loadSnapshot(std::unique_ptr<Snapshot> source);
+
+    // Writer side. Changes are invisible to readers until publish().
+    bool add(std::string_view command, std::string_view description, int points);
+    bool remove(std::string_view command);
+    bool contains(std::string_view command) const;
+    int getSize() const;
+    void publish();
+
+    // Admin search over the writer side, so unpublished changes are found.
+    // See CommandSearch.
+    std::vector<Command> findSubstring(std::string_view text, int limit) const;
+    std::vector<Command> suggest(std::string_view name, int maxDistance, int limit) const;
+
+    // Reader side: the latest published Version. Lock-free.
+    ReadGuard read() const;
+};
+
+#endif
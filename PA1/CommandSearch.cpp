@@ -0,0 +1,352 @@
+#include "CommandSearch.h"
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+namespace {
+
+// Fills the two padding positions before and after a name.
+const char PAD = '\0';
+
+char lower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+void sortUnique(std::vector<std::uint32_t>& values) {
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+}
+
+}
+
+CommandSearch::CommandSearch() : deadCount(0) {}
+
+// Trigrams of the lowercased text. Padded trigrams also cover the start and
+// end of the text, so a text of length L yields L + 2 of them.
+void CommandSearch::collectTrigrams(std::string_view text, bool padded, std::vector<Trigram>& out) {
+    int length = static_cast<int>(text.size());
+    int offset = padded ? 2 : 0;
+    int total = length + 2 * offset;
+    for (int i = 0; i + 3 <= total; i++) {
+        Trigram gram = 0;
+        for (int j = i; j < i + 3; j++) {
+            int k = j - offset;
+            char c = k < 0 || k >= length ? PAD : lower(text[k]);
+            gram = (gram << 8) | static_cast<unsigned char>(c);
+        }
+        out.push_back(gram);
+    }
+}
+
+void CommandSearch::gramsOf(const Command& cmd, std::vector<Trigram>& nameGrams,
+                            std::vector<Trigram>& textGrams) {
+    nameGrams.clear();
+    collectTrigrams(cmd.command, true, nameGrams);
+    sortUnique(nameGrams);
+
+    textGrams.clear();
+    collectTrigrams(cmd.command, false, textGrams);
+    collectTrigrams(cmd.description, false, textGrams);
+    sortUnique(textGrams);
+}
+
+// New ids are always the largest so far, so appending keeps every posting
+// list sorted.
+void CommandSearch::add(const Command& cmd) {
+    std::uint32_t id = static_cast<std::uint32_t>(entries.size());
+    entries.push_back(cmd);
+    alive.push_back(true);
+    letterMasks.push_back(letterMask(cmd.command));
+    idByName[cmd.command] = id;
+
+    gramsOf(cmd, grams, textGrams);
+    for (Trigram gram : grams) {
+        nameIndex[gram].push_back(id);
+    }
+    for (Trigram gram : textGrams) {
+        textIndex[gram].push_back(id);
+    }
+}
+
+void CommandSearch::remove(std::string_view name) {
+    std::unordered_map<std::string_view, std::uint32_t>::iterator found = idByName.find(name);
+    if (found == idByName.end()) {
+        return;
+    }
+    std::uint32_t id = found->second;
+    idByName.erase(found);
+    alive[id] = false;
+
+    gramsOf(entries[id], grams, textGrams);
+    erasePostings(nameIndex, grams, id);
+    erasePostings(textIndex, textGrams, id);
+
+    deadCount++;
+    if (deadCount >= MIN_DEAD_TO_COMPACT && deadCount > entries.size() - deadCount) {
+        compact();
+    }
+}
+
+void CommandSearch::clear() {
+    entries.clear();
+    alive.clear();
+    letterMasks.clear();
+    deadCount = 0;
+    idByName.clear();
+    nameIndex.clear();
+    textIndex.clear();
+    std::vector<int>().swap(sharedCounts);
+}
+
+// Drops removed commands and renumbers the live ones in their current
+// order. Posting lists only hold live ids, and the renumbering keeps their
+// order, so they stay sorted. Costs one pass over every posting list, paid
+// for by the removals since the last compaction.
+void CommandSearch::compact() {
+    std::vector<std::uint32_t> newIds(entries.size());
+    std::size_t kept = 0;
+    for (std::size_t id = 0; id < entries.size(); id++) {
+        if (!alive[id]) {
+            continue;
+        }
+        newIds[id] = static_cast<std::uint32_t>(kept);
+        entries[kept] = entries[id];
+        letterMasks[kept] = letterMasks[id];
+        kept++;
+    }
+    entries.resize(kept);
+    letterMasks.resize(kept);
+    alive.assign(kept, true);
+    deadCount = 0;
+
+    for (std::pair<const std::string_view, std::uint32_t>& named : idByName) {
+        named.second = newIds[named.second];
+    }
+    renumber(nameIndex, newIds);
+    renumber(textIndex, newIds);
+
+    // Release the memory the removed commands took.
+    entries.shrink_to_fit();
+    letterMasks.shrink_to_fit();
+    alive.shrink_to_fit();
+    std::vector<int>().swap(sharedCounts);
+}
+
+void CommandSearch::renumber(std::unordered_map<Trigram, Postings>& index,
+                             const std::vector<std::uint32_t>& newIds) {
+    for (std::pair<const Trigram, Postings>& list : index) {
+        for (std::uint32_t& id : list.second) {
+            id = newIds[id];
+        }
+    }
+}
+
+void CommandSearch::erasePostings(std::unordered_map<Trigram, Postings>& index,
+                                  const std::vector<Trigram>& grams, std::uint32_t id) {
+    for (Trigram gram : grams) {
+        std::unordered_map<Trigram, Postings>::iterator list = index.find(gram);
+        Postings& ids = list->second;
+        ids.erase(std::lower_bound(ids.begin(), ids.end(), id));
+        if (ids.empty()) {
+            index.erase(list);
+        }
+    }
+}
+
+std::vector<Command> CommandSearch::findSubstring(std::string_view text, int limit) const {
+    std::vector<Command> results;
+    if (text.empty() || limit <= 0) {
+        return results;
+    }
+
+    // Too short to have a trigram: check every live command.
+    if (text.size() < 3) {
+        for (std::size_t id = 0; id < entries.size() && static_cast<int>(results.size()) < limit; id++) {
+            if (alive[id] && (containsIgnoreCase(entries[id].command, text) ||
+                              containsIgnoreCase(entries[id].description, text))) {
+                results.push_back(entries[id]);
+            }
+        }
+        return results;
+    }
+
+    grams.clear();
+    collectTrigrams(text, false, grams);
+    sortUnique(grams);
+
+    // Intersect starting from the shortest posting list.
+    std::vector<const Postings*> lists;
+    for (Trigram gram : grams) {
+        std::unordered_map<Trigram, Postings>::const_iterator list = textIndex.find(gram);
+        if (list == textIndex.end()) {
+            return results;
+        }
+        lists.push_back(&list->second);
+    }
+    std::sort(lists.begin(), lists.end(), [](const Postings* a, const Postings* b) {
+        return a->size() < b->size();
+    });
+
+    // Walk the shortest list and look each id up in the others. Cursors
+    // only move forward, and the walk stops once `limit` commands match.
+    std::vector<Postings::const_iterator> cursors;
+    for (const Postings* ids : lists) {
+        cursors.push_back(ids->begin());
+    }
+    for (std::uint32_t id : *lists[0]) {
+        bool inAll = true;
+        for (std::size_t i = 1; i < lists.size() && inAll; i++) {
+            cursors[i] = std::lower_bound(cursors[i], lists[i]->end(), id);
+            if (cursors[i] == lists[i]->end()) {
+                return results;
+            }
+            inAll = *cursors[i] == id;
+        }
+        if (!inAll) {
+            continue;
+        }
+
+        // Sharing every trigram does not make a substring; check the text.
+        const Command& cmd = entries[id];
+        if (containsIgnoreCase(cmd.command, text) || containsIgnoreCase(cmd.description, text)) {
+            results.push_back(cmd);
+            if (static_cast<int>(results.size()) == limit) {
+                break;
+            }
+        }
+    }
+    return results;
+}
+
+std::vector<Command> CommandSearch::suggest(std::string_view name, int maxDistance, int limit) const {
+    std::vector<Command> results;
+    if (name.empty() || limit <= 0) {
+        return results;
+    }
+
+    // Short names tolerate fewer edits: with two edits, "ls" would match
+    // every two-letter name.
+    if (name.size() <= 2) {
+        maxDistance = 0;
+    } else if (name.size() <= 5) {
+        maxDistance = std::min(maxDistance, 1);
+    }
+
+    grams.clear();
+    collectTrigrams(name, true, grams);
+    sortUnique(grams);
+
+    // Count the trigrams each command shares with the query. One edit
+    // changes at most four trigrams (a swap touches two positions), so
+    // fewer than `required` shared trigrams rules a command out.
+    int required = std::max(1, static_cast<int>(grams.size()) - 4 * maxDistance);
+    sharedCounts.resize(entries.size());
+    candidates.clear();
+    for (Trigram gram : grams) {
+        std::unordered_map<Trigram, Postings>::const_iterator list = nameIndex.find(gram);
+        if (list == nameIndex.end()) {
+            continue;
+        }
+        for (std::uint32_t id : list->second) {
+            if (sharedCounts[id]++ == 0) {
+                candidates.push_back(id);
+            }
+        }
+    }
+
+    // Each edit adds at most one character class to a name and takes at
+    // most one away, so a name missing more than maxDistance of the
+    // query's classes, or having more than maxDistance others, is too far
+    // away. This rejects most candidates before the distance is computed.
+    std::uint32_t queryMask = letterMask(name);
+    std::vector<std::pair<int, std::uint32_t> > matches;
+    for (std::uint32_t id : candidates) {
+        if (sharedCounts[id] >= required &&
+            bitCount(queryMask & ~letterMasks[id]) <= maxDistance &&
+            bitCount(letterMasks[id] & ~queryMask) <= maxDistance) {
+            int distance = boundedDistance(name, entries[id].command, maxDistance);
+            if (distance <= maxDistance) {
+                matches.push_back(std::make_pair(distance, id));
+            }
+        }
+        sharedCounts[id] = 0;
+    }
+
+    std::sort(matches.begin(), matches.end(),
+              [this](const std::pair<int, std::uint32_t>& a, const std::pair<int, std::uint32_t>& b) {
+        if (a.first != b.first) {
+            return a.first < b.first;
+        }
+        return entries[a.second].command < entries[b.second].command;
+    });
+    for (std::size_t i = 0; i < matches.size() && static_cast<int>(i) < limit; i++) {
+        results.push_back(entries[matches[i].second]);
+    }
+    return results;
+}
+
+// Character c sets bit lower(c) % 32, so the letters get bits of their own
+// and other characters share them; sharing only weakens the bound.
+std::uint32_t CommandSearch::letterMask(std::string_view name) {
+    std::uint32_t mask = 0;
+    for (char c : name) {
+        mask |= std::uint32_t(1) << (static_cast<unsigned char>(lower(c)) % 32);
+    }
+    return mask;
+}
+
+int CommandSearch::bitCount(std::uint32_t bits) {
+#if defined(__GNUC__)
+    return __builtin_popcount(bits);
+#else
+    int count = 0;
+    for (; bits; bits &= bits - 1) count++;
+    return count;
+#endif
+}
+
+bool CommandSearch::containsIgnoreCase(std::string_view haystack, std::string_view needle) {
+    return std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end(),
+                       [](char a, char b) { return lower(a) == lower(b); }) != haystack.end();
+}
+
+// Case-insensitive edit distance counting insertions, deletions,
+// substitutions and swaps of adjacent characters (optimal string
+// alignment), or bound + 1 as soon as it is known to exceed bound.
+int CommandSearch::boundedDistance(std::string_view a, std::string_view b, int bound) const {
+    int lengthA = static_cast<int>(a.size());
+    int lengthB = static_cast<int>(b.size());
+    if (std::abs(lengthA - lengthB) > bound) {
+        return bound + 1;
+    }
+
+    // Three rows: two back (for swaps), previous and current.
+    int width = lengthB + 1;
+    distanceRows.resize(3 * width);
+    int* older = &distanceRows[0];
+    int* previous = &distanceRows[width];
+    int* current = &distanceRows[2 * width];
+    for (int j = 0; j <= lengthB; j++) {
+        previous[j] = j;
+    }
+    for (int i = 1; i <= lengthA; i++) {
+        current[0] = i;
+        int rowMin = i;
+        for (int j = 1; j <= lengthB; j++) {
+            int cost = lower(a[i - 1]) == lower(b[j - 1]) ? 0 : 1;
+            int best = std::min(std::min(previous[j] + 1, current[j - 1] + 1), previous[j - 1] + cost);
+            if (i > 1 && j > 1 && lower(a[i - 1]) == lower(b[j - 2]) &&
+                lower(a[i - 2]) == lower(b[j - 1])) {
+                best = std::min(best, older[j - 2] + 1);
+            }
+            current[j] = best;
+            rowMin = std::min(rowMin, best);
+        }
+        if (rowMin > bound) {
+            return bound + 1;
+        }
+        std::swap(older, previous);
+        std::swap(previous, current);
+    }
+    return std::min(previous[lengthB], bound + 1);
+}
@@ -0,0 +1,87 @@
+#ifndef COMMAND_SEARCH_H
+#define COMMAND_SEARCH_H
+
+#include "Command.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Trigram inverted index over command names and descriptions, for admin
+// search. Every command gets an id in the order it was added; each posting
+// list holds, in ascending order, the ids of the commands containing one
+// lowercase trigram. Matching is ASCII case-insensitive.
+//
+// The indexed Commands' text must outlive the index (the catalog's arena
+// guarantees this).
+class CommandSearch {
+public:
+    CommandSearch();
+
+    CommandSearch(const CommandSearch&) = delete;
+    CommandSearch& operator=(const CommandSearch&) = delete;
+
+    void add(const Command& cmd);
+    void remove(std::string_view name);
+    // Forgets every command, e.g. before their text is moved.
+    void clear();
+
+    // Commands whose name or description contains text, in the order they
+    // were added. Candidates come from intersecting the posting lists of
+    // the query's trigrams and are then checked directly.
+    std::vector<Command> findSubstring(std::string_view text, int limit) const;
+
+    // Commands whose name is within maxDistance edits of name, closest
+    // first. Swapping two adjacent letters counts as one edit. Names of up
+    // to 5 characters allow at most one edit, and of up to 2 none.
+    // Candidates must share enough padded name trigrams to be reachable in
+    // that many edits (and at least one), and are then verified with a
+    // bounded edit distance.
+    std::vector<Command> suggest(std::string_view name, int maxDistance, int limit) const;
+
+private:
+    typedef std::uint32_t Trigram;
+    typedef std::vector<std::uint32_t> Postings;
+
+    // Once removed commands outnumber live ones (and MIN_DEAD_TO_COMPACT),
+    // live commands are renumbered 0..n-1, keeping their order.
+    static const std::size_t MIN_DEAD_TO_COMPACT = 1024;
+
+    // Indexed by id. Removed commands keep their id, and are no longer
+    // alive, until the next compaction.
+    std::vector<Command> entries;
+    std::vector<bool> alive;
+    // One bit per lowercase character class present in the name, for a
+    // cheap bound on the edit distance before computing it.
+    std::vector<std::uint32_t> letterMasks;
+    std::size_t deadCount;
+    std::unordered_map<std::string_view, std::uint32_t> idByName;
+    // Padded trigrams of names only, for suggest().
+    std::unordered_map<Trigram, Postings> nameIndex;
+    // Unpadded trigrams of names and descriptions, for findSubstring().
+    std::unordered_map<Trigram, Postings> textIndex;
+
+    // Scratch space reused across calls.
+    mutable std::vector<Trigram> grams;
+    std::vector<Trigram> textGrams;
+    mutable std::vector<std::uint32_t> candidates;
+    // Per-id shared trigram counts for suggest(); all zero between calls.
+    mutable std::vector<int> sharedCounts;
+    mutable std::vector<int> distanceRows;
+
+    static void collectTrigrams(std::string_view text, bool padded, std::vector<Trigram>& out);
+    static bool containsIgnoreCase(std::string_view haystack, std::string_view needle);
+    int boundedDistance(std::string_view a, std::string_view b, int bound) const;
+    static void gramsOf(const Command& cmd, std::vector<Trigram>& nameGrams,
+                        std::vector<Trigram>& textGrams);
+    static void erasePostings(std::unordered_map<Trigram, Postings>& index,
+                              const std::vector<Trigram>& grams, std::uint32_t id);
+    static std::uint32_t letterMask(std::string_view name);
+    static int bitCount(std::uint32_t bits);
+    void compact();
+    static void renumber(std::unordered_map<Trigram, Postings>& index,
+                         const std::vector<std::uint32_t>& newIds);
+};
+
+#endif
@@ -0,0 +1,49 @@
+#include "CsvReader.h"
+#include <charconv>
+
+CsvReader::CsvReader(std::string_view text) : text(text), position(0) {}
+
+bool CsvReader::next(std::vector<std::string_view>& fields) {
+    while (position < text.size()) {
+        fields.clear();
+        std::size_t fieldStart = position;
+        bool inQuotes = false;
+        bool blank = true;
+
+        while (position < text.size() && text[position] != '\n') {
+            char c = text[position];
+            if (c == '"') {
+                inQuotes = !inQuotes;
+            } else if (c == ',' && !inQuotes) {
+                fields.push_back(trim(text.substr(fieldStart, position - fieldStart)));
+                fieldStart = position + 1;
+            }
+            if (c != '\r') {
+                blank = false;
+            }
+            position++;
+        }
+        fields.push_back(trim(text.substr(fieldStart, position - fieldStart)));
+        position++;  // Past the newline.
+
+        if (!blank) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string_view CsvReader::trim(std::string_view field) {
+    std::size_t start = field.find_first_not_of(" \t\r\n\"");
+    if (start == std::string_view::npos) {
+        return std::string_view();
+    }
+    std::size_t end = field.find_last_not_of(" \t\r\n\"");
+    return field.substr(start, end - start + 1);
+}
+
+bool CsvReader::toInt(std::string_view field, int& value) {
+    const char* end = field.data() + field.size();
+    std::from_chars_result result = std::from_chars(field.data(), end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
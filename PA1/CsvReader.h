@@ -0,0 +1,29 @@
+#ifndef CSV_READER_H
+#define CSV_READER_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+// Splits CSV text into rows of fields in a single pass, without copying:
+// each field is a view into the text being read. Rows are lines, and commas
+// inside double quotes do not split a field. Surrounding whitespace and
+// quotes are trimmed from every field, and blank lines are skipped.
+class CsvReader {
+private:
+    std::string_view text;
+    std::size_t position;
+
+public:
+    explicit CsvReader(std::string_view text);
+
+    // Reads the next row into fields (reusing its storage). Returns false
+    // once the text is exhausted.
+    bool next(std::vector<std::string_view>& fields);
+
+    static std::string_view trim(std::string_view field);
+    // Parses a whole field as a decimal int.
+    static bool toInt(std::string_view field, int& value);
+};
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef EPOCH_PTR_H
+#define EPOCH_PTR_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Pointer to an immutable T that readers follow without locks while a
+// writer replaces it (read-copy-update). Replaced objects are freed by
+// epoch-based reclamation: each reader announces the epoch it started in,
+// and an object retired in epoch E is deleted once every active reader
+// started after E.
+//
+// read() is lock-free as long as fewer than MAX_READERS guards are alive
+// at once; beyond that, new readers yield until a slot frees up. publish()
+// calls must be serialized by the caller.
+template <typename T>
+class EpochPtr {
+public:
+    static const int MAX_READERS = 64;
+
+private:
+    // One reader's announced epoch, or 0 when the slot is free. Each slot
+    // has its own cache line so readers do not contend.
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> epoch;
+
+        Slot() : epoch(0) {}
+    };
+
+    struct Retired {
+        std::uint64_t epoch;
+        T* object;
+    };
+
+    std::atomic<T*> current;
+    std::atomic<std::uint64_t> globalEpoch;
+    mutable Slot slots[MAX_READERS];
+    std::vector<Retired> retired;
+
+    // Deletes every retired object that no active reader can still see.
+    void reclaim() {
+        std::uint64_t oldestActive = UINT64_MAX;
+        for (const Slot& slot : slots) {
+            std::uint64_t epoch = slot.epoch.load();
+            if (epoch != 0 && epoch < oldestActive) {
+                oldestActive = epoch;
+            }
+        }
+
+        std::size_t kept = 0;
+        for (const Retired& entry : retired) {
+            if (entry.epoch < oldestActive) {
+                delete entry.object;
+            } else {
+                retired[kept++] = entry;
+            }
+        }
+        retired.resize(kept);
+    }
+
+public:
+    // Keeps the object it was created with alive until destroyed.
+    class Guard {
+    private:
+        const EpochPtr* owner;
+        int slot;
+        const T* object;
+
+        friend class EpochPtr;
+
+        Guard(const EpochPtr* owner, int slot, const T* object)
+            : owner(owner), slot(slot), object(object) {}
+
+    public:
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        Guard(Guard&& other) noexcept : owner(other.owner), slot(other.slot), object(other.object) {
+            other.owner = nullptr;
+        }
+
+        ~Guard() {
+            if (owner != nullptr) {
+                owner->slots[slot].epoch.store(0);
+            }
+        }
+
+        const T& operator*() const {
+            return *object;
+        }
+
+        const T* operator->() const {
+            return object;
+        }
+    };
+
+    explicit EpochPtr(std::unique_ptr<T> initial) : current(initial.release()), globalEpoch(1) {}
+
+    ~EpochPtr() {
+        delete current.load();
+        for (const Retired& entry : retired) {
+            delete entry.object;
+        }
+    }
+
+    EpochPtr(const EpochPtr&) = delete;
+    EpochPtr& operator=(const EpochPtr&) = delete;
+
+    // Claims a reader slot, announces the current epoch in it, then loads
+    // the pointer. A writer that misses the announcement swapped the
+    // pointer before this load, so the reader never sees a retired object.
+    Guard read() const {
+        static thread_local int hint = 0;
+        for (int attempt = 0;; attempt++) {
+            int slot = (hint + attempt) % MAX_READERS;
+            std::uint64_t expected = 0;
+            if (slots[slot].epoch.compare_exchange_strong(expected, globalEpoch.load())) {
+                hint = slot;
+                return Guard(this, slot, current.load());
+            }
+            if (attempt % MAX_READERS == MAX_READERS - 1) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Makes next the object new readers see and retires the previous one.
+    void publish(std::unique_ptr<T> next) {
+        T* previous = current.exchange(next.release());
+        retired.push_back(Retired{globalEpoch.fetch_add(1), previous});
+        reclaim();
+    }
+};
+
+#endif
@@ -1,18 +1,168 @@
 #include "Game.h"
+#include "CsvReader.h"
+#include "MappedFile.h"
+#include "QuizSession.h"
+#include "Snapshot.h"
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <functional>
+#include <string_view>
 #include <algorithm>
 #include <random>
 #include <chrono>
 #include <iomanip>
+#include <memory>
+#include <utility>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char* const COMMANDS_FILE = "commands.csv";
+const char* const LEADERBOARD_FILE = "leaderboard.csv";
+// Binary copy of both CSV files, written after them; see Snapshot.
+const char* const SNAPSHOT_FILE = "game.snapshot";
+const char* const JOURNAL_FILE = "game.journal";
+// The journal being folded into a snapshot by a compaction.
+const char* const COMPACTING_JOURNAL_FILE = "game.journal.compacting";
+
+// Writes `lines` to path via a temporary file, fsync and rename, so a crash
+// leaves either the old file or the new one, never a partial file.
+template <typename Range, typename Format>
+bool writeFileAtomically(const std::string& path, const Range& lines, Format format) {
+    std::string temporary = path + ".tmp";
+    std::ofstream file(temporary);
+    if (!file.is_open()) {
+        return false;
+    }
+    for (const auto& item : lines) {
+        format(file, item);
+    }
+    file.close();
+    if (file.fail()) {
+        return false;
+    }
+
+    int fd = open(temporary.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+template <typename Range>
+bool writeCommandsFile(const Range& commands) {
+    return writeFileAtomically(COMMANDS_FILE, commands, [](std::ofstream& file, const Command& cmd) {
+        file << cmd.command << ",\"" << cmd.description << "\"," << cmd.points << "\n";
+    });
+}
+
+template <typename Range>
+bool writeLeaderboardFile(const Range& players) {
+    return writeFileAtomically(LEADERBOARD_FILE, players, [](std::ofstream& file, const Player& player) {
+        file << player.name << "," << player.score << "\n";
+    });
+}
+
+template <typename Range>
+bool writeSnapshotFile(const Range& commands, const std::vector<Player>& players) {
+    Snapshot::Builder builder;
+    for (const Command& cmd : commands) {
+        builder.addCommand(cmd);
+    }
+    for (const Player& player : players) {
+        builder.addPlayer(player.name, player.score);
+    }
+    std::string contents[] = {builder.finish()};
+    return writeFileAtomically(SNAPSHOT_FILE, contents, [](std::ofstream& file, const std::string& bytes) {
+        file.write(bytes.data(), bytes.size());
+    });
+}
+
+// Appends the file at `from` to the file at `to` and syncs it. On failure
+// `to` is cut back to its old length, so it never ends in a partial copy.
+bool appendFileTo(const char* from, const char* to) {
+    int source = open(from, O_RDONLY | O_CLOEXEC);
+    if (source < 0) {
+        return false;
+    }
+    int target = open(to, O_WRONLY | O_APPEND | O_CLOEXEC);
+    struct stat targetInfo;
+    if (target < 0 || fstat(target, &targetInfo) != 0) {
+        if (target >= 0) {
+            close(target);
+        }
+        close(source);
+        return false;
+    }
+
+    bool copied = true;
+    char buffer[64 * 1024];
+    while (copied) {
+        ssize_t count = read(source, buffer, sizeof(buffer));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            copied = count == 0;
+            break;
+        }
+        ssize_t written = 0;
+        while (copied && written < count) {
+            ssize_t n = write(target, buffer + written, count - written);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            copied = n > 0;
+            written += copied ? n : 0;
+        }
+    }
+    copied = copied && fdatasync(target) == 0;
+    if (!copied && ftruncate(target, targetInfo.st_size) == 0) {
+        fdatasync(target);
+    }
+    close(target);
+    close(source);
+    return copied;
+}
+
+// True if path exists and was modified no earlier than other, or other does
+// not exist.
+bool isAtLeastAsNew(const char* path, const char* other) {
+    struct stat pathInfo;
+    struct stat otherInfo;
+    if (stat(path, &pathInfo) != 0) {
+        return false;
+    }
+    if (stat(other, &otherInfo) != 0) {
+        return true;
+    }
+    if (pathInfo.st_mtim.tv_sec != otherInfo.st_mtim.tv_sec) {
+        return pathInfo.st_mtim.tv_sec > otherInfo.st_mtim.tv_sec;
+    }
+    return pathInfo.st_mtim.tv_nsec >= otherInfo.st_mtim.tv_nsec;
+}
 
-Game::Game() {
-    loadCommands();
-    loadLeaderboard();
+}
+
+Game::Game() : rng(std::random_device()()), compacting(false) {
+    if (!loadSnapshot()) {
+        loadCommands();
+        loadLeaderboard();
+    }
+    replayJournals();
+    if (!journal.open(JOURNAL_FILE)) {
+        std::cout << "Warning: could not open " << JOURNAL_FILE
+                  << "; changes will only be saved on exit." << std::endl;
+    }
 }
 
 Game::~Game() {
+    waitForCompaction();
 }
 
 void Game::run() {
@@ -46,6 +196,9 @@ void Game::run() {
                 showLeaderboard();
                 break;
             case 7:
+                searchCommands();
+                break;
+            case 8:
                 saveAndExit();
                 running = false;
                 break;
@@ -70,14 +223,15 @@ void Game::displayMenu() {
     std::cout << "4. Remove a command" << std::endl;
     std::cout << "5. Display all commands" << std::endl;
     std::cout << "6. Show leaderboard" << std::endl;
-    std::cout << "7. Save and exit" << std::endl;
-    std::cout << "Enter your choice (1-7): ";
+    std::cout << "7. Search commands" << std::endl;
+    std::cout << "8. Save and exit" << std::endl;
+    std::cout << "Enter your choice (1-8): ";
 }
 
 int Game::getValidMenuChoice() {
     int choice;
-    while (!(std::cin >> choice) || choice < 1 || choice > 7) {
-        std::cout << "Invalid input. Please enter a number between 1 and 7: ";
+    while (!(std::cin >> choice) || choice < 1 || choice > 8) {
+        std::cout << "Invalid input. Please enter a number between 1 and 8: ";
         std::cin.clear();
         std::cin.ignore(10000, '\n');
     }
@@ -101,100 +255,38 @@ void Game::displayRules() {
 }
 
 void Game::playNewGame() {
-    if (commands.getSize() < QUESTIONS_PER_GAME) {
+    if (commands.getSize() < QuizSession::QUESTIONS_PER_GAME) {
         std::cout << "Not enough commands in the database. Need at least " 
-                  << QUESTIONS_PER_GAME << " commands to play." << std::endl;
+                  << QuizSession::QUESTIONS_PER_GAME << " commands to play." << std::endl;
         return;
     }
 
-    std::string playerName;
-    std::cout << "Enter your name: ";
-    std::getline(std::cin, playerName);
-    
-    if (playerName.empty()) {
-        std::cout << "Invalid name. Game cancelled." << std::endl;
-        return;
+    QuizSession session(commands, rng);
+    std::string output;
+    session.start(output);
+    std::cout << output;
+
+    std::string input;
+    std::getline(std::cin, input);
+    output.clear();
+    session.handleInput(input, output);
+    std::cout << output;
+
+    while (session.getState() == QuizSession::AWAITING_ANSWER && std::cin >> input) {
+        output.clear();
+        session.handleInput(input, output);
+        std::cout << output;
     }
 
-    int score = 0;
-    std::vector<int> questionIndices = generateRandomQuestions();
-
-    std::cout << "\n=== GAME START ===" << std::endl;
-    std::cout << "Hello " << playerName << "! Let's begin the quiz." << std::endl;
-    std::cout << std::endl;
-
-    for (int i = 0; i < QUESTIONS_PER_GAME; i++) {
-        const Command& currentCommand = commands.at(questionIndices[i]);
-        std::vector<std::string> choices = generateChoices(currentCommand);
-
-        std::cout << "Question " << (i + 1) << "/" << QUESTIONS_PER_GAME << std::endl;
-        std::cout << "Command: " << currentCommand.command << std::endl;
-        std::cout << "What does this command do?" << std::endl;
-        
-        for (int j = 0; j < 3; j++) {
-            std::cout << (j + 1) << ". " << choices[j] << std::endl;
-        }
-
-        int answer;
-        std::cout << "Your answer (1-3): ";
-        while (!(std::cin >> answer) || answer < 1 || answer > 3) {
-            std::cout << "Invalid input. Please enter 1, 2, or 3: ";
-            std::cin.clear();
-            std::cin.ignore(10000, '\n');
-        }
-
-        if (choices[answer - 1] == currentCommand.description) {
-            std::cout << "Correct! +" << currentCommand.points << " points" << std::endl;
-            score += currentCommand.points;
-        } else {
-            std::cout << "Wrong! The correct answer was: " << currentCommand.description << std::endl;
-        }
-        std::cout << "Current score: " << score << std::endl;
-        std::cout << std::endl;
+    if (session.getState() != QuizSession::FINISHED) {
+        return;
     }
 
-    std::cout << "=== GAME OVER ===" << std::endl;
-    std::cout << playerName << ", your final score is: " << score << " points" << std::endl;
-
-    Player newPlayer(playerName, score);
-    updateLeaderboard(newPlayer);
+    recordScore(Player(session.getPlayerName(), session.getScore()));
 
     std::cout << "Your score has been added to the leaderboard!" << std::endl;
-}
-
-std::vector<int> Game::generateRandomQuestions() {
-    std::vector<int> indices;
-    for (int i = 0; i < commands.getSize(); i++) {
-        indices.push_back(i);
-    }
-
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::shuffle(indices.begin(), indices.end(), gen);
-
-    return std::vector<int>(indices.begin(), indices.begin() + QUESTIONS_PER_GAME);
-}
-
-std::vector<std::string> Game::generateChoices(const Command& correctCommand) {
-    std::vector<std::string> choices;
-    choices.push_back(correctCommand.description);
-
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, commands.getSize() - 1);
-
-    while (choices.size() < 3) {
-        int randomIndex = dis(gen);
-        const Command& randomCommand = commands.at(randomIndex);
-        
-        if (randomCommand.description != correctCommand.description &&
-            std::find(choices.begin(), choices.end(), randomCommand.description) == choices.end()) {
-            choices.push_back(randomCommand.description);
-        }
-    }
-
-    std::shuffle(choices.begin(), choices.end(), gen);
-    return choices;
+    std::cout << "Your best score ranks #" << leaderboard.rankOf(session.getPlayerName())
+              << " of " << leaderboard.getSize() << " players." << std::endl;
 }
 
 void Game::addCommand() {
@@ -210,8 +302,7 @@ void Game::addCommand() {
         return;
     }
 
-    Command tempCommand(command, "", 0);
-    if (commands.find(tempCommand)) {
+    if (commands.contains(command)) {
         std::cout << "Warning: Command '" << command << "' already exists!" << std::endl;
         return;
     }
@@ -233,10 +324,12 @@ void Game::addCommand() {
     }
     std::cin.ignore();
 
-    Command newCommand(command, description, points);
-    commands.insertBack(newCommand);
+    journal.appendAdd(command, description, points);
+    commands.add(command, description, points);
+    commands.publish();
+    maybeCompact();
 
-    std::cout << "Command added successfully! (Will be saved on exit)" << std::endl;
+    std::cout << "Command added successfully!" << std::endl;
 }
 
 void Game::removeCommand() {
@@ -250,72 +343,125 @@ void Game::removeCommand() {
         return;
     }
 
-    Command tempCommand(command, "", 0);
-    if (commands.remove(tempCommand)) {
-        std::cout << "Command removed successfully! (Will be saved on exit)" << std::endl;
+    if (commands.remove(command)) {
+        journal.appendRemove(command);
+        commands.publish();
+        maybeCompact();
+        std::cout << "Command removed successfully!" << std::endl;
     } else {
         std::cout << "Warning: Command '" << command << "' not found!" << std::endl;
+        printSuggestions(command);
     }
 }
 
+void Game::searchCommands() {
+    std::string text;
+    std::cout << "Enter text to search for: ";
+    std::getline(std::cin, text);
+    text = trim(text);
+
+    if (text.empty()) {
+        std::cout << "Invalid search. Operation cancelled." << std::endl;
+        return;
+    }
+
+    std::vector<Command> matches = commands.findSubstring(text, MAX_SEARCH_RESULTS);
+    if (matches.empty()) {
+        std::cout << "No commands match '" << text << "'." << std::endl;
+        printSuggestions(text);
+        return;
+    }
+    for (const Command& cmd : matches) {
+        std::cout << cmd.command << " - " << cmd.description << " (" << cmd.points << " points)" << std::endl;
+    }
+    if (static_cast<int>(matches.size()) == MAX_SEARCH_RESULTS) {
+        std::cout << "(Showing the first " << MAX_SEARCH_RESULTS << " matches.)" << std::endl;
+    }
+}
+
+void Game::printSuggestions(const std::string& name) {
+    std::vector<Command> close = commands.suggest(name, SUGGESTION_DISTANCE, MAX_SUGGESTIONS);
+    if (close.empty()) {
+        return;
+    }
+    std::cout << "Did you mean: ";
+    for (size_t i = 0; i < close.size(); i++) {
+        std::cout << (i > 0 ? ", " : "") << close[i].command;
+    }
+    std::cout << "?" << std::endl;
+}
+
+// Lists the commands sorted by name. The sort works on a temporary List of
+// copies, which only copy views into the catalog's text, so the catalog and
+// the saved CSV keep their order. The read guard keeps that text alive.
 void Game::displayAllCommands() {
-    if (commands.isEmpty()) {
+    CommandCatalog::ReadGuard version = commands.read();
+    if (version->isEmpty()) {
         std::cout << "No commands in the database." << std::endl;
         return;
     }
 
+    List<Command> byName;
+    for (const Command& cmd : *version) {
+        byName.insertBack(cmd);
+    }
+    byName.sort([](const Command& a, const Command& b) {
+        return a.command < b.command;
+    });
+
     std::cout << "\n=== ALL COMMANDS ===" << std::endl;
     std::cout << std::setw(15) << "Command" << " | " 
               << std::setw(50) << "Description" << " | " 
               << "Points" << std::endl;
     std::cout << std::string(75, '-') << std::endl;
 
-    for (int i = 0; i < commands.getSize(); i++) {
-        const Command& cmd = commands.at(i);
+    for (const Command& cmd : byName) {
         std::cout << std::setw(15) << cmd.command << " | " 
                   << std::setw(50) << cmd.description.substr(0, 50) << " | " 
                   << cmd.points << std::endl;
     }
-    std::cout << "\nTotal commands: " << commands.getSize() << std::endl;
+    std::cout << "\nTotal commands: " << version->getSize() << std::endl;
 }
 
 void Game::showLeaderboard() {
     std::cout << "\n=== LEADERBOARD (TOP 3) ===" << std::endl;
     
-    if (leaderboard.empty()) {
+    if (leaderboard.isEmpty()) {
         std::cout << "No players yet. Be the first to play!" << std::endl;
         return;
     }
 
-    for (size_t i = 0; i < leaderboard.size(); i++) {
-        std::cout << (i + 1) << ". " << leaderboard[i] << std::endl;
+    std::vector<Player> leaders = leaderboard.top(MAX_LEADERBOARD_SIZE);
+    for (size_t i = 0; i < leaders.size(); i++) {
+        std::cout << (i + 1) << ". " << leaders[i] << std::endl;
     }
 }
 
-void Game::updateLeaderboard(const Player& newPlayer) {
-    auto insertPos = leaderboard.begin();
-    for (auto it = leaderboard.begin(); it != leaderboard.end(); ++it) {
-        if (newPlayer.score > it->score) {
-            insertPos = it;
-            break;
-        }
-        insertPos = it + 1;
-    }
+void Game::updateLeaderboard(Player newPlayer) {
+    leaderboard.submit(std::move(newPlayer.name), newPlayer.score);
+}
 
-    leaderboard.insert(insertPos, newPlayer);
+const CommandCatalog& Game::getCatalog() {
+    return commands;
+}
 
-    if (leaderboard.size() > MAX_LEADERBOARD_SIZE) {
-        leaderboard.resize(MAX_LEADERBOARD_SIZE);
-    }
+void Game::recordScore(Player player) {
+    journal.appendScore(player.name, player.score);
+    updateLeaderboard(std::move(player));
+    maybeCompact();
 }
 
 void Game::saveAndExit() {
     std::cout << "Saving data..." << std::endl;
-    
+
+    waitForCompaction();
     bool commandsSaved = saveCommands();
     bool leaderboardSaved = saveLeaderboard();
+    saveSnapshot();
 
     if (commandsSaved && leaderboardSaved) {
+        journal.truncate();
+        std::remove(COMPACTING_JOURNAL_FILE);
         std::cout << "All data saved successfully!" << std::endl;
     } else {
         std::cout << "Warning: Some data may not have been saved properly." << std::endl;
@@ -325,90 +471,145 @@ void Game::saveAndExit() {
 }
 
 bool Game::loadCommands() {
-    std::ifstream file("commands.csv");
-    if (!file.is_open()) {
+    if (!commands.loadCsv(COMMANDS_FILE)) {
         std::cout << "commands.csv not found. Please create the file with Linux commands." << std::endl;
         return false;
     }
+    return true;
+}
 
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
+bool Game::saveCommands() {
+    return writeCommandsFile(*commands.read());
+}
 
-        std::vector<std::string> tokens = parseCSVLine(line);
-        if (tokens.size() >= 3) {
-            std::string command = trim(tokens[0]);
-            std::string description = trim(tokens[1]);
-            int points = std::stoi(trim(tokens[2]));
+bool Game::loadLeaderboard() {
+    MappedFile file;
+    if (!file.open(LEADERBOARD_FILE, MappedFile::READ_ONCE)) {
+        return true;
+    }
 
-            Command cmd(command, description, points);
-            commands.insertBack(cmd);
+    CsvReader reader(file.contents());
+    std::vector<std::string_view> fields;
+    int score;
+    while (reader.next(fields)) {
+        if (fields.size() >= 2 && CsvReader::toInt(fields[1], score)) {
+            leaderboard.submit(std::string(fields[0]), score);
         }
     }
-
-    file.close();
     return true;
 }
 
-bool Game::saveCommands() {
-    std::ofstream file("commands.csv");
-    if (!file.is_open()) {
+bool Game::saveLeaderboard() {
+    return writeLeaderboardFile(leaderboard.top(leaderboard.getSize()));
+}
+
+// Starts from the binary snapshot when it is at least as new as both CSV
+// files. A CSV file changed since the last save (say, edited by hand) is
+// newer, so the CSV files are imported instead.
+bool Game::loadSnapshot() {
+    if (!isAtLeastAsNew(SNAPSHOT_FILE, COMMANDS_FILE) ||
+        !isAtLeastAsNew(SNAPSHOT_FILE, LEADERBOARD_FILE)) {
         return false;
     }
-
-    for (int i = 0; i < commands.getSize(); i++) {
-        const Command& cmd = commands.at(i);
-        file << cmd.command << ",\"" << cmd.description << "\"," << cmd.points << std::endl;
+    std::unique_ptr<Snapshot> snapshot(new Snapshot());
+    if (!snapshot->open(SNAPSHOT_FILE)) {
+        return false;
     }
 
-    file.close();
+    for (int i = 0; i < snapshot->getPlayerCount(); i++) {
+        leaderboard.submit(std::string(snapshot->playerNameAt(i)), snapshot->playerScoreAt(i));
+    }
+    commands.loadSnapshot(std::move(snapshot));
     return true;
 }
 
-bool Game::loadLeaderboard() {
-    std::ifstream file("leaderboard.csv");
-    if (!file.is_open()) {
-        return true;
-    }
-
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
+// Written after the CSV files, so a snapshot that fails to save is older
+// than them and ignored on the next start.
+bool Game::saveSnapshot() {
+    return writeSnapshotFile(*commands.read(), leaderboard.top(leaderboard.getSize()));
+}
 
-        std::vector<std::string> tokens = parseCSVLine(line);
-        if (tokens.size() >= 2) {
-            std::string name = trim(tokens[0]);
-            int score = std::stoi(trim(tokens[1]));
+// Brings the in-memory state up to date with changes made since the CSV
+// files were written. A leftover compacting journal means the last
+// compaction never finished, so it is replayed first and then folded into
+// fresh snapshots right away.
+void Game::replayJournals() {
+    std::function<void(const Journal::Record&)> apply = [this](const Journal::Record& record) {
+        applyJournalRecord(record);
+    };
+
+    bool interrupted = Journal::replay(COMPACTING_JOURNAL_FILE, apply);
+    Journal::replay(JOURNAL_FILE, apply);
+    commands.publish();
+
+    if (interrupted && saveCommands() && saveLeaderboard()) {
+        saveSnapshot();
+        std::remove(COMPACTING_JOURNAL_FILE);
+    }
+}
 
-            Player player(name, score);
-            leaderboard.push_back(player);
-        }
+void Game::applyJournalRecord(const Journal::Record& record) {
+    if (record.type == Journal::ADD_COMMAND) {
+        commands.add(record.name, record.description, record.value);
+    } else if (record.type == Journal::REMOVE_COMMAND) {
+        commands.remove(record.name);
+    } else if (record.type == Journal::SCORE) {
+        leaderboard.submit(record.name, record.value);
     }
+}
 
-    file.close();
-    
-    std::sort(leaderboard.begin(), leaderboard.end(), 
-              [](const Player& a, const Player& b) { return a.score > b.score; });
-    
-    if (leaderboard.size() > MAX_LEADERBOARD_SIZE) {
-        leaderboard.resize(MAX_LEADERBOARD_SIZE);
+// Starts a background compaction once the journal is large enough. The
+// current state is copied and the journal is swapped for an empty one on
+// this thread; only the slow snapshot writing happens in the background.
+void Game::maybeCompact() {
+    if (!journal.isOpen() || journal.getSize() < COMPACT_THRESHOLD_BYTES || compacting) {
+        return;
+    }
+    waitForCompaction();
+
+    CommandCatalog::ReadGuard version = commands.read();
+    std::vector<Command> commandSnapshot(version->begin(), version->end());
+    std::vector<Player> playerSnapshot = leaderboard.top(leaderboard.getSize());
+
+    journal.close();
+    bool rotated;
+    if (access(COMPACTING_JOURNAL_FILE, F_OK) == 0) {
+        // A failed compaction left records that no CSV file or snapshot
+        // holds yet. Renaming over them would lose them, so the live
+        // journal is added to them instead, and this compaction covers
+        // both.
+        rotated = appendFileTo(JOURNAL_FILE, COMPACTING_JOURNAL_FILE);
+        journal.open(JOURNAL_FILE);
+        rotated = rotated && journal.truncate();
+    } else {
+        rotated = std::rename(JOURNAL_FILE, COMPACTING_JOURNAL_FILE) == 0;
+        journal.open(JOURNAL_FILE);
+    }
+    if (!rotated) {
+        return;
     }
 
-    return true;
+    compacting = true;
+    compactionThread = std::thread(&Game::compactInBackground, this, version->getText(),
+                                   std::move(commandSnapshot), std::move(playerSnapshot));
 }
 
-bool Game::saveLeaderboard() {
-    std::ofstream file("leaderboard.csv");
-    if (!file.is_open()) {
-        return false;
+// The TextRef is only held, so the copied commands' text stays alive
+// while they are written.
+void Game::compactInBackground(CommandCatalog::TextRef,
+                               std::vector<Command> commandSnapshot,
+                               std::vector<Player> playerSnapshot) {
+    if (writeCommandsFile(commandSnapshot) && writeLeaderboardFile(playerSnapshot)) {
+        writeSnapshotFile(commandSnapshot, playerSnapshot);
+        std::remove(COMPACTING_JOURNAL_FILE);
     }
+    compacting = false;
+}
 
-    for (const Player& player : leaderboard) {
-        file << player.name << "," << player.score << std::endl;
+void Game::waitForCompaction() {
+    if (compactionThread.joinable()) {
+        compactionThread.join();
     }
-
-    file.close();
-    return true;
 }
 
 std::string Game::trim(const std::string& str) {
@@ -418,26 +619,3 @@ std::string Game::trim(const std::string& str) {
     size_t end = str.find_last_not_of(" \t\r\n\"");
     return str.substr(start, end - start + 1);
 }
-
-std::vector<std::string> Game::parseCSVLine(const std::string& line) {
-    std::vector<std::string> tokens;
-    std::stringstream ss(line);
-    std::string token;
-    bool inQuotes = false;
-    std::string current = "";
-
-    for (char c : line) {
-        if (c == '"') {
-            inQuotes = !inQuotes;
-        } else if (c == ',' && !inQuotes) {
-            tokens.push_back(current);
-            current = "";
-        } else {
-            current += c;
-        }
-    }
-    tokens.push_back(current);
-
-    return tokens;
-}
-
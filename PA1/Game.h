@@ -1,31 +1,55 @@
 #ifndef GAME_H
 #define GAME_H
 
-#include "List.h"
-#include "Command.h"
+#include "CommandCatalog.h"
+#include "Journal.h"
+#include "Leaderboard.h"
 #include "Player.h"
+#include <atomic>
+#include <random>
+#include <thread>
 #include <vector>
 #include <string>
 
 class Game {
 private:
-    List<Command> commands;
-    std::vector<Player> leaderboard;
+    CommandCatalog commands;
+    Leaderboard leaderboard;
+    // Seeded once per program run instead of once per question.
+    std::mt19937 rng;
+    // How many leaders "Show leaderboard" lists; every player is kept.
     static const int MAX_LEADERBOARD_SIZE = 3;
-    static const int QUESTIONS_PER_GAME = 20;
+    // Limits for "Search commands" and "Did you mean" hints.
+    static const int MAX_SEARCH_RESULTS = 20;
+    static const int MAX_SUGGESTIONS = 5;
+    static const int SUGGESTION_DISTANCE = 2;
+
+    // Every change is journaled as it happens. Once the journal passes
+    // COMPACT_THRESHOLD_BYTES, a background thread writes fresh CSV files
+    // and a binary snapshot, and the journal starts over.
+    Journal journal;
+    std::thread compactionThread;
+    std::atomic<bool> compacting;
+    static const long long COMPACT_THRESHOLD_BYTES = 1 << 20;
 
     bool loadCommands();
     bool saveCommands();
     bool loadLeaderboard();
     bool saveLeaderboard();
-    void updateLeaderboard(const Player& newPlayer);
-    std::vector<int> generateRandomQuestions();
-    std::vector<std::string> generateChoices(const Command& correctCommand);
+    bool loadSnapshot();
+    bool saveSnapshot();
+    void replayJournals();
+    void applyJournalRecord(const Journal::Record& record);
+    void maybeCompact();
+    void compactInBackground(CommandCatalog::TextRef commandText, std::vector<Command> commandSnapshot,
+                             std::vector<Player> playerSnapshot);
+    void waitForCompaction();
+    void updateLeaderboard(Player newPlayer);
     void displayRules();
     void displayMenu();
     int getValidMenuChoice();
+    void printSuggestions(const std::string& name);
     std::string trim(const std::string& str);
-    std::vector<std::string> parseCSVLine(const std::string& line);
 
 public:
     Game();
@@ -38,7 +62,13 @@ public:
     void removeCommand();
     void displayAllCommands();
     void showLeaderboard();
+    void searchCommands();
     void saveAndExit();
+
+    // Used by the quiz server: the catalog that sessions read published
+    // versions of, and the sink for finished games.
+    const CommandCatalog& getCatalog();
+    void recordScore(Player player);
 };
 
 #endif
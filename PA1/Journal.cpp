@@ -0,0 +1,226 @@
+#include "Journal.h"
+#include <cerrno>
+#include <chrono>
+#include <fstream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const int Journal::SYNC_INTERVAL_MS;
+
+Journal::Journal() : fd(-1), bytes(0), unsynced(0), stopping(false) {}
+
+Journal::~Journal() {
+    close();
+}
+
+bool Journal::open(const std::string& path) {
+    close();
+    std::lock_guard<std::mutex> guard(lock);
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    bytes = fstat(fd, &info) == 0 ? info.st_size : 0;
+    unsynced = 0;
+    stopping = false;
+    flusher = std::thread(&Journal::flushPeriodically, this);
+    return true;
+}
+
+// Stops the flusher first, so it never sees the file half closed.
+void Journal::close() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    flusherWake.notify_one();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    closeLocked();
+}
+
+void Journal::closeLocked() {
+    if (fd >= 0) {
+        syncLocked();
+        ::close(fd);
+        fd = -1;
+    }
+    bytes = 0;
+}
+
+bool Journal::isOpen() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return fd >= 0;
+}
+
+bool Journal::truncate() {
+    std::lock_guard<std::mutex> guard(lock);
+    if (fd < 0 || ftruncate(fd, 0) != 0) {
+        return false;
+    }
+    bytes = 0;
+    return syncLocked();
+}
+
+bool Journal::appendAdd(const std::string& command, const std::string& description, int points) {
+    line.assign(1, ADD_COMMAND);
+    appendField(line, command);
+    appendField(line, std::to_string(points));
+    appendField(line, description);
+    return append();
+}
+
+bool Journal::appendRemove(const std::string& command) {
+    line.assign(1, REMOVE_COMMAND);
+    appendField(line, command);
+    return append();
+}
+
+bool Journal::appendScore(const std::string& name, int score) {
+    line.assign(1, SCORE);
+    appendField(line, name);
+    appendField(line, std::to_string(score));
+    return append();
+}
+
+bool Journal::sync() {
+    std::lock_guard<std::mutex> guard(lock);
+    return syncLocked();
+}
+
+bool Journal::syncLocked() {
+    if (fd < 0) {
+        return false;
+    }
+    unsynced = 0;
+    return fdatasync(fd) == 0;
+}
+
+// Syncs any waiting records once per SYNC_INTERVAL_MS, so a quiet journal
+// does not hold a partial batch indefinitely.
+void Journal::flushPeriodically() {
+    std::unique_lock<std::mutex> guard(lock);
+    while (!flusherWake.wait_for(guard, std::chrono::milliseconds(SYNC_INTERVAL_MS),
+                                 [this] { return stopping; })) {
+        if (unsynced > 0) {
+            syncLocked();
+        }
+    }
+}
+
+long long Journal::getSize() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return bytes;
+}
+
+// Writes the record in `line` with a single write() so the kernel sees it
+// whole, then syncs if the batch is full; otherwise the flusher syncs it
+// within SYNC_INTERVAL_MS.
+bool Journal::append() {
+    std::lock_guard<std::mutex> guard(lock);
+    if (fd < 0) {
+        return false;
+    }
+    line += '\n';
+
+    size_t written = 0;
+    while (written < line.size()) {
+        ssize_t n = write(fd, line.data() + written, line.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        written += n;
+    }
+    bytes += line.size();
+
+    if (++unsynced >= SYNC_BATCH) {
+        return syncLocked();
+    }
+    return true;
+}
+
+// Fields are tab-separated; tabs, newlines and backslashes inside a field
+// are backslash-escaped.
+void Journal::appendField(std::string& out, const std::string& field) {
+    out += '\t';
+    for (char c : field) {
+        if (c == '\\') {
+            out += "\\\\";
+        } else if (c == '\t') {
+            out += "\\t";
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+}
+
+std::string Journal::unescape(const std::string& field) {
+    std::string result;
+    result.reserve(field.size());
+    for (size_t i = 0; i < field.size(); i++) {
+        if (field[i] == '\\' && i + 1 < field.size()) {
+            char next = field[++i];
+            result += next == 't' ? '\t' : next == 'n' ? '\n' : next;
+        } else {
+            result += field[i];
+        }
+    }
+    return result;
+}
+
+bool Journal::replay(const std::string& path, const std::function<void(const Record&)>& apply) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string text;
+    std::vector<std::string> fields;
+    while (std::getline(file, text)) {
+        if (file.eof()) {
+            break;  // No trailing newline: torn write from a crash.
+        }
+        fields.clear();
+        size_t start = 0;
+        while (true) {
+            size_t tab = text.find('\t', start);
+            fields.push_back(unescape(text.substr(start, tab - start)));
+            if (tab == std::string::npos) {
+                break;
+            }
+            start = tab + 1;
+        }
+
+        Record record;
+        record.type = fields[0].empty() ? '\0' : fields[0][0];
+        record.value = 0;
+        try {
+            if (record.type == ADD_COMMAND && fields.size() == 4) {
+                record.name = fields[1];
+                record.value = std::stoi(fields[2]);
+                record.description = fields[3];
+            } else if (record.type == REMOVE_COMMAND && fields.size() == 2) {
+                record.name = fields[1];
+            } else if (record.type == SCORE && fields.size() == 3) {
+                record.name = fields[1];
+                record.value = std::stoi(fields[2]);
+            } else {
+                continue;
+            }
+        } catch (const std::exception&) {
+            continue;
+        }
+        apply(record);
+    }
+    return true;
+}
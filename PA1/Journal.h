@@ -0,0 +1,84 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Append-only log of catalog and leaderboard changes. Each change is one
+// tab-separated text line written straight to the file. The file is
+// fsync'd once SYNC_BATCH records are waiting, and a background thread
+// syncs whatever is waiting every SYNC_INTERVAL_MS, so a crash loses at
+// most the records of the last interval.
+//
+//   A <command> <points> <description>    command added
+//   R <command>                           command removed
+//   S <player> <score>                    game finished
+//
+// Replaying a journal on top of a snapshot that already includes some of
+// its records is harmless: adds of existing commands, removes of missing
+// ones and scores below a player's best are all no-ops.
+class Journal {
+public:
+    struct Record {
+        char type;
+        std::string name;
+        std::string description;
+        int value;
+    };
+
+    static const char ADD_COMMAND = 'A';
+    static const char REMOVE_COMMAND = 'R';
+    static const char SCORE = 'S';
+
+    static const int SYNC_BATCH = 32;
+    static const int SYNC_INTERVAL_MS = 500;
+
+    Journal();
+    ~Journal();
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const;
+    // Empties the open journal, e.g. after a full snapshot has been saved.
+    bool truncate();
+
+    bool appendAdd(const std::string& command, const std::string& description, int points);
+    bool appendRemove(const std::string& command);
+    bool appendScore(const std::string& name, int score);
+    bool sync();
+
+    long long getSize() const;
+
+    // Calls apply for every complete record in the file, in order. A torn
+    // final line from a crash mid-write is ignored. Returns false if the
+    // file does not exist.
+    static bool replay(const std::string& path, const std::function<void(const Record&)>& apply);
+
+private:
+    // Record being built; only the appending thread touches it.
+    std::string line;
+    // Guards everything below against the flusher thread.
+    mutable std::mutex lock;
+    int fd;
+    long long bytes;
+    int unsynced;
+    // Runs while the journal is open; woken early only to stop.
+    std::thread flusher;
+    std::condition_variable flusherWake;
+    bool stopping;
+
+    bool append();
+    bool syncLocked();
+    void closeLocked();
+    void flushPeriodically();
+    static void appendField(std::string& out, const std::string& field);
+    static std::string unescape(const std::string& field);
+};
+
+#endif
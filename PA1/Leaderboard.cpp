@@ -0,0 +1,239 @@
+#include "Leaderboard.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+Leaderboard::Leaderboard() : root(nullptr) {}
+
+Leaderboard::~Leaderboard() {
+    destroy(root);
+}
+
+bool Leaderboard::ranksBefore(const Player& a, const Player& b) {
+    if (a.score != b.score) {
+        return a.score > b.score;
+    }
+    return a.name < b.name;
+}
+
+int Leaderboard::height(RankNode* node) {
+    return node ? node->height : 0;
+}
+
+int Leaderboard::count(RankNode* node) {
+    return node ? node->count : 0;
+}
+
+void Leaderboard::update(RankNode* node) {
+    node->height = 1 + std::max(height(node->left), height(node->right));
+    node->count = 1 + count(node->left) + count(node->right);
+}
+
+Leaderboard::RankNode* Leaderboard::rotateRight(RankNode* y) {
+    RankNode* x = y->left;
+    y->left = x->right;
+    x->right = y;
+    update(y);
+    update(x);
+    return x;
+}
+
+Leaderboard::RankNode* Leaderboard::rotateLeft(RankNode* x) {
+    RankNode* y = x->right;
+    x->right = y->left;
+    y->left = x;
+    update(x);
+    update(y);
+    return y;
+}
+
+// Restores the AVL height invariant at node after one of its subtrees
+// changed height by at most one.
+Leaderboard::RankNode* Leaderboard::rebalance(RankNode* node) {
+    update(node);
+    int balance = height(node->left) - height(node->right);
+    if (balance > 1) {
+        if (height(node->left->left) < height(node->left->right)) {
+            node->left = rotateLeft(node->left);
+        }
+        return rotateRight(node);
+    }
+    if (balance < -1) {
+        if (height(node->right->right) < height(node->right->left)) {
+            node->right = rotateRight(node->right);
+        }
+        return rotateLeft(node);
+    }
+    return node;
+}
+
+void Leaderboard::destroy(RankNode* node) {
+    if (node) {
+        destroy(node->left);
+        destroy(node->right);
+        delete node;
+    }
+}
+
+Leaderboard::RankNode* Leaderboard::insertNode(RankNode* node, RankNode* fresh) {
+    if (!node) {
+        return fresh;
+    }
+    if (ranksBefore(fresh->player, node->player)) {
+        node->left = insertNode(node->left, fresh);
+    } else {
+        node->right = insertNode(node->right, fresh);
+    }
+    return rebalance(node);
+}
+
+// Unlinks the leftmost node of the subtree into `min`.
+Leaderboard::RankNode* Leaderboard::detachMin(RankNode* node, RankNode*& min) {
+    if (!node->left) {
+        min = node;
+        return node->right;
+    }
+    node->left = detachMin(node->left, min);
+    return rebalance(node);
+}
+
+// Removes the node whose player equals key. Nodes are relinked rather than
+// having their payloads copied, so byName pointers to other players stay
+// valid. key must not refer into the tree: the matching node is deleted
+// while the callers up the recursion still hold key.
+Leaderboard::RankNode* Leaderboard::eraseNode(RankNode* node, const Player& key) {
+    if (!node) {
+        return nullptr;
+    }
+    if (ranksBefore(key, node->player)) {
+        node->left = eraseNode(node->left, key);
+    } else if (ranksBefore(node->player, key)) {
+        node->right = eraseNode(node->right, key);
+    } else {
+        RankNode* left = node->left;
+        RankNode* right = node->right;
+        delete node;
+        if (!left || !right) {
+            return left ? left : right;
+        }
+        RankNode* successor = nullptr;
+        RankNode* rest = detachMin(right, successor);
+        successor->left = left;
+        successor->right = rest;
+        return rebalance(successor);
+    }
+    return rebalance(node);
+}
+
+// In-order walk starting at fromRank: descend once to that rank, keeping
+// the ancestors still to be visited on a stack, then step through
+// successors. Costs O(log n + maxCount).
+std::vector<Player> Leaderboard::collect(int fromRank, int maxCount) const {
+    std::vector<Player> result;
+    if (fromRank < 1 || fromRank > count(root) || maxCount <= 0) {
+        return result;
+    }
+
+    std::vector<RankNode*> pending;
+    RankNode* node = root;
+    int remaining = fromRank;
+    while (node) {
+        int leftCount = count(node->left);
+        if (remaining <= leftCount) {
+            pending.push_back(node);
+            node = node->left;
+        } else if (remaining == leftCount + 1) {
+            pending.push_back(node);
+            break;
+        } else {
+            remaining -= leftCount + 1;
+            node = node->right;
+        }
+    }
+
+    while (!pending.empty() && static_cast<int>(result.size()) < maxCount) {
+        node = pending.back();
+        pending.pop_back();
+        result.push_back(node->player);
+        for (RankNode* next = node->right; next; next = next->left) {
+            pending.push_back(next);
+        }
+    }
+    return result;
+}
+
+bool Leaderboard::submit(std::string name, int score) {
+    std::unordered_map<std::string, RankNode*>::iterator entry = byName.find(name);
+    if (entry != byName.end()) {
+        if (score <= entry->second->player.score) {
+            return false;
+        }
+        // Copied, since eraseNode() deletes the node it comes from.
+        Player previous = entry->second->player;
+        root = eraseNode(root, previous);
+        byName.erase(entry);
+    }
+
+    RankNode* fresh = new RankNode(Player(name, score));
+    root = insertNode(root, fresh);
+    byName.emplace(std::move(name), fresh);
+    return true;
+}
+
+int Leaderboard::getSize() const {
+    return count(root);
+}
+
+bool Leaderboard::isEmpty() const {
+    return root == nullptr;
+}
+
+int Leaderboard::rankOf(const std::string& name) const {
+    std::unordered_map<std::string, RankNode*>::const_iterator entry = byName.find(name);
+    if (entry == byName.end()) {
+        return 0;
+    }
+
+    const Player& key = entry->second->player;
+    int rank = 0;
+    RankNode* node = root;
+    while (node) {
+        if (ranksBefore(key, node->player)) {
+            node = node->left;
+        } else if (ranksBefore(node->player, key)) {
+            rank += count(node->left) + 1;
+            node = node->right;
+        } else {
+            return rank + count(node->left) + 1;
+        }
+    }
+    return 0;
+}
+
+const Player& Leaderboard::atRank(int rank) const {
+    if (rank < 1 || rank > count(root)) {
+        throw std::out_of_range("Rank out of bounds");
+    }
+    RankNode* node = root;
+    while (true) {
+        int leftCount = count(node->left);
+        if (rank <= leftCount) {
+            node = node->left;
+        } else if (rank == leftCount + 1) {
+            return node->player;
+        } else {
+            rank -= leftCount + 1;
+            node = node->right;
+        }
+    }
+}
+
+std::vector<Player> Leaderboard::top(int k) const {
+    return collect(1, k);
+}
+
+std::vector<Player> Leaderboard::around(int rank, int radius) const {
+    int first = std::max(1, rank - radius);
+    int last = std::min(count(root), rank + radius);
+    return collect(first, last - first + 1);
+}
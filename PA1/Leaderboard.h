@@ -0,0 +1,67 @@
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include "Player.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Every player's best score, ranked. Players are kept in an AVL tree
+// ordered by (score descending, name ascending) where each node also
+// stores its subtree size, so rank and select queries are O(log n).
+// A name -> node hash index finds a player's current entry in O(1).
+// Ranks are 1-based.
+class Leaderboard {
+private:
+    struct RankNode {
+        Player player;
+        RankNode* left;
+        RankNode* right;
+        int height;
+        int count;
+
+        explicit RankNode(Player p)
+            : player(std::move(p)), left(nullptr), right(nullptr), height(1), count(1) {}
+    };
+
+    RankNode* root;
+    std::unordered_map<std::string, RankNode*> byName;
+
+    static bool ranksBefore(const Player& a, const Player& b);
+    static int height(RankNode* node);
+    static int count(RankNode* node);
+    static void update(RankNode* node);
+    static RankNode* rotateRight(RankNode* y);
+    static RankNode* rotateLeft(RankNode* x);
+    static RankNode* rebalance(RankNode* node);
+    static void destroy(RankNode* node);
+
+    RankNode* insertNode(RankNode* node, RankNode* fresh);
+    RankNode* eraseNode(RankNode* node, const Player& key);
+    RankNode* detachMin(RankNode* node, RankNode*& min);
+    std::vector<Player> collect(int fromRank, int maxCount) const;
+
+public:
+    Leaderboard();
+    ~Leaderboard();
+
+    Leaderboard(const Leaderboard&) = delete;
+    Leaderboard& operator=(const Leaderboard&) = delete;
+
+    // Records a score; only a player's best score is kept. Returns true if
+    // the player is new or improved their best.
+    bool submit(std::string name, int score);
+
+    int getSize() const;
+    bool isEmpty() const;
+
+    // Rank of the named player, or 0 if they have never played.
+    int rankOf(const std::string& name) const;
+    // Player at the given rank; throws std::out_of_range if there is none.
+    const Player& atRank(int rank) const;
+
+    std::vector<Player> top(int k) const;
+    std::vector<Player> around(int rank, int radius) const;
+};
+
+#endif
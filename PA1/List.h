@@ -2,98 +2,534 @@
 #define LIST_H
 
 #include "Node.h"
+#include "NodePool.h"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
-template <typename T>
+// Unrolled linked list: elements live in fixed-capacity chunks (see Node.h).
+// Inserting at either end is O(1), removal shifts the rest of one chunk
+// and may merge it with a neighbour, and at(i) binary-searches a
+// prefix-count index over the chunks. Chunks come from Alloc (see
+// NodePool.h), which defaults to a recycling slab pool.
+template <typename T, typename Alloc = NodePool<Node<T> > >
 class List {
 private:
+    Alloc allocator;
     Node<T>* head;
+    Node<T>* tail;
     int size;
 
+    // Prefix-count index: chunkStart[c] is the list index of the first
+    // element in chunkIndex[c]. Rebuilt lazily by at() after mutations.
+    mutable std::vector<Node<T>*> chunkIndex;
+    mutable std::vector<int> chunkStart;
+    mutable bool indexValid;
+
+    // Called for each element that a chunk merge moves to another chunk, so
+    // owners that map elements to chunks can follow them. It belongs to the
+    // owner, so copies and moves of the list do not carry it over.
+    std::function<void(const T&, Node<T>*)> onRelocate;
+
+    Node<T>* createChunk() {
+        return new (allocator.allocate()) Node<T>();
+    }
+
+    void destroyChunk(Node<T>* chunk) {
+        chunk->~Node<T>();
+        allocator.deallocate(chunk);
+    }
+
+    Node<T>* appendChunk() {
+        Node<T>* chunk = createChunk();
+        chunk->prev = tail;
+        if (tail != nullptr) {
+            tail->next = chunk;
+        } else {
+            head = chunk;
+        }
+        tail = chunk;
+        if (indexValid) {
+            chunkIndex.push_back(chunk);
+            chunkStart.push_back(size);
+        }
+        return chunk;
+    }
+
+    Node<T>* prependChunk() {
+        Node<T>* chunk = createChunk();
+        chunk->next = head;
+        if (head != nullptr) {
+            head->prev = chunk;
+        } else {
+            tail = chunk;
+        }
+        head = chunk;
+        indexValid = false;
+        return chunk;
+    }
+
+    void unlinkChunk(Node<T>* chunk) {
+        if (chunk->prev != nullptr) {
+            chunk->prev->next = chunk->next;
+        } else {
+            head = chunk->next;
+        }
+        if (chunk->next != nullptr) {
+            chunk->next->prev = chunk->prev;
+        } else {
+            tail = chunk->prev;
+        }
+        destroyChunk(chunk);
+    }
+
+    // Moves every element of chunk->next into chunk and frees the emptied
+    // neighbour. The caller checks that both fit in one chunk.
+    void absorbNext(Node<T>* chunk) {
+        Node<T>* victim = chunk->next;
+        for (int i = 0; i < victim->count; i++) {
+            chunk->emplaceAt(chunk->count, std::move(victim->at(i)));
+            if (onRelocate) {
+                onRelocate(chunk->at(chunk->count - 1), chunk);
+            }
+        }
+        victim->clear();
+        unlinkChunk(victim);
+    }
+
+    // Keeps chunks at least half full after an erase by merging with a
+    // neighbour when the two fit together; empty chunks are released.
+    void rebalanceAfterErase(Node<T>* chunk) {
+        if (chunk->count == 0) {
+            unlinkChunk(chunk);
+        } else if (chunk->count < Node<T>::CAPACITY / 2) {
+            if (chunk->next != nullptr &&
+                chunk->count + chunk->next->count <= Node<T>::CAPACITY) {
+                absorbNext(chunk);
+            } else if (chunk->prev != nullptr &&
+                       chunk->prev->count + chunk->count <= Node<T>::CAPACITY) {
+                absorbNext(chunk->prev);
+            }
+        }
+    }
+
+    void rebuildIndex() const {
+        chunkIndex.clear();
+        chunkStart.clear();
+        int start = 0;
+        for (Node<T>* chunk = head; chunk != nullptr; chunk = chunk->next) {
+            chunkIndex.push_back(chunk);
+            chunkStart.push_back(start);
+            start += chunk->count;
+        }
+        indexValid = true;
+    }
+
+    // A sorted chain of chunks: head->prev and tail->next are null.
+    struct Run {
+        Node<T>* head;
+        Node<T>* tail;
+
+        Run() : head(nullptr), tail(nullptr) {}
+        Run(Node<T>* h, Node<T>* t) : head(h), tail(t) {}
+    };
+
+    // Insertion sort inside one chunk: stable, needs no buffer, and chunks
+    // are small.
+    template <typename Compare>
+    static void sortChunk(Node<T>* chunk, Compare& comp) {
+        for (int i = 1; i < chunk->count; i++) {
+            if (!comp(chunk->at(i), chunk->at(i - 1))) {
+                continue;
+            }
+            T value = std::move(chunk->at(i));
+            int j = i;
+            do {
+                chunk->at(j) = std::move(chunk->at(j - 1));
+                j--;
+            } while (j > 0 && comp(value, chunk->at(j - 1)));
+            chunk->at(j) = std::move(value);
+        }
+    }
+
+    void appendToRun(Run& run, Node<T>* first, Node<T>* last) {
+        first->prev = run.tail;
+        if (run.tail != nullptr) {
+            run.tail->next = first;
+        } else {
+            run.head = first;
+        }
+        run.tail = last;
+    }
+
+    void moveIntoRun(Run& run, T& value) {
+        if (run.tail == nullptr || run.tail->isFull()) {
+            Node<T>* chunk = createChunk();
+            appendToRun(run, chunk, chunk);
+        }
+        run.tail->emplaceAt(run.tail->count, std::move(value));
+    }
+
+    // Moves what is left of a run, from slot `slot` of `chunk` on, to the
+    // end of `out`. Whole chunks this list owns are relinked as they are;
+    // elements are moved only out of a partly consumed chunk or out of
+    // another list's chunks, which go back to `owner` once drained.
+    void drainRun(Run& out, Node<T>* chunk, int slot, Node<T>* last, List<T, Alloc>& owner) {
+        while (chunk != nullptr && (slot > 0 || &owner != this)) {
+            for (; slot < chunk->count; slot++) {
+                moveIntoRun(out, chunk->at(slot));
+            }
+            Node<T>* next = chunk->next;
+            owner.destroyChunk(chunk);
+            chunk = next;
+            slot = 0;
+        }
+        if (chunk != nullptr) {
+            appendToRun(out, chunk, last);
+        }
+    }
+
+    // Stable merge of two sorted runs; on ties `left` comes first. `left`
+    // belongs to this list and `right` to `rightOwner`. Output goes into
+    // freshly packed chunks and every input chunk is freed as soon as it is
+    // drained, so at most one extra chunk is live at a time. Runs that are
+    // already in order are just concatenated.
+    template <typename Compare>
+    Run mergeRuns(Run left, Run right, List<T, Alloc>& rightOwner, Compare& comp) {
+        if (left.head == nullptr && &rightOwner == this) {
+            return right;
+        }
+        if (left.head != nullptr && right.head != nullptr && &rightOwner == this &&
+            !comp(right.head->at(0), left.tail->at(left.tail->count - 1))) {
+            appendToRun(left, right.head, right.tail);
+            return left;
+        }
+
+        Run out;
+        Node<T>* a = left.head;
+        Node<T>* b = right.head;
+        int i = 0;
+        int j = 0;
+        while (a != nullptr && b != nullptr) {
+            if (comp(b->at(j), a->at(i))) {
+                moveIntoRun(out, b->at(j));
+                if (++j == b->count) {
+                    Node<T>* next = b->next;
+                    rightOwner.destroyChunk(b);
+                    b = next;
+                    j = 0;
+                }
+            } else {
+                moveIntoRun(out, a->at(i));
+                if (++i == a->count) {
+                    Node<T>* next = a->next;
+                    destroyChunk(a);
+                    a = next;
+                    i = 0;
+                }
+            }
+        }
+        drainRun(out, a, i, left.tail, *this);
+        drainRun(out, b, j, right.tail, rightOwner);
+        return out;
+    }
+
+    // Installs a sorted run as the whole list and tells the relocation
+    // handler where every element now lives.
+    void adoptRun(Run run) {
+        head = run.head;
+        tail = run.tail;
+        indexValid = false;
+        if (onRelocate) {
+            for (Node<T>* chunk = head; chunk != nullptr; chunk = chunk->next) {
+                for (int i = 0; i < chunk->count; i++) {
+                    onRelocate(chunk->at(i), chunk);
+                }
+            }
+        }
+    }
+
+    Node<T>* locate(int index, int& slot) const {
+        if (index < 0 || index >= size) {
+            throw std::out_of_range("Index out of bounds");
+        }
+        if (!indexValid) {
+            rebuildIndex();
+        }
+        std::size_t c = std::upper_bound(chunkStart.begin(), chunkStart.end(), index) -
+                        chunkStart.begin() - 1;
+        slot = index - chunkStart[c];
+        return chunkIndex[c];
+    }
+
 public:
-    List() : head(nullptr), size(0) {}
+    // Forward iterator over the elements, chunk by chunk.
+    template <typename U, typename NodePtr>
+    class BasicIterator {
+    private:
+        NodePtr chunk;
+        int slot;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef U* pointer;
+        typedef U& reference;
+
+        BasicIterator(NodePtr c, int s) : chunk(c), slot(s) {}
+
+        U& operator*() const {
+            return chunk->at(slot);
+        }
+
+        U* operator->() const {
+            return &chunk->at(slot);
+        }
+
+        BasicIterator& operator++() {
+            if (++slot == chunk->count) {
+                chunk = chunk->next;
+                slot = 0;
+            }
+            return *this;
+        }
+
+        BasicIterator operator++(int) {
+            BasicIterator old = *this;
+            ++(*this);
+            return old;
+        }
+
+        bool operator==(const BasicIterator& other) const {
+            return chunk == other.chunk && slot == other.slot;
+        }
+
+        bool operator!=(const BasicIterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    typedef BasicIterator<T, Node<T>*> iterator;
+    typedef BasicIterator<const T, const Node<T>*> const_iterator;
+
+    List() : head(nullptr), tail(nullptr), size(0), indexValid(true) {}
 
     ~List() {
         clear();
     }
 
-    List(const List<T>& other) : head(nullptr), size(0) {
+    List(const List<T, Alloc>& other) : head(nullptr), tail(nullptr), size(0), indexValid(true) {
         *this = other;
     }
 
-    List<T>& operator=(const List<T>& other) {
+    List<T, Alloc>& operator=(const List<T, Alloc>& other) {
         if (this != &other) {
             clear();
-            Node<T>* current = other.head;
-            while (current != nullptr) {
-                insertBack(current->data);
-                current = current->next;
+            for (const T& item : other) {
+                insertBack(item);
             }
         }
         return *this;
     }
 
+    // Moving steals the chunks together with the allocator that owns them.
+    List(List<T, Alloc>&& other) noexcept
+        : allocator(std::move(other.allocator)), head(other.head), tail(other.tail),
+          size(other.size), chunkIndex(std::move(other.chunkIndex)),
+          chunkStart(std::move(other.chunkStart)), indexValid(other.indexValid) {
+        other.head = nullptr;
+        other.tail = nullptr;
+        other.size = 0;
+        other.chunkIndex.clear();
+        other.chunkStart.clear();
+        other.indexValid = true;
+    }
+
+    List<T, Alloc>& operator=(List<T, Alloc>&& other) noexcept {
+        if (this != &other) {
+            clear();
+            allocator = std::move(other.allocator);
+            std::swap(head, other.head);
+            std::swap(tail, other.tail);
+            std::swap(size, other.size);
+            chunkIndex.swap(other.chunkIndex);
+            chunkStart.swap(other.chunkStart);
+            std::swap(indexValid, other.indexValid);
+        }
+        return *this;
+    }
+
+    iterator begin() {
+        return iterator(head, 0);
+    }
+
+    iterator end() {
+        return iterator(nullptr, 0);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(head, 0);
+    }
+
+    const_iterator end() const {
+        return const_iterator(nullptr, 0);
+    }
+
     void insertFront(const T& data) {
-        Node<T>* newNode = new Node<T>(data);
-        newNode->next = head;
-        head = newNode;
-        size++;
+        emplaceFront(data);
+    }
+
+    void insertFront(T&& data) {
+        emplaceFront(std::move(data));
     }
 
     void insertBack(const T& data) {
-        Node<T>* newNode = new Node<T>(data);
-        if (head == nullptr) {
-            head = newNode;
-        } else {
-            Node<T>* current = head;
-            while (current->next != nullptr) {
-                current = current->next;
-            }
-            current->next = newNode;
+        emplaceBack(data);
+    }
+
+    void insertBack(T&& data) {
+        emplaceBack(std::move(data));
+    }
+
+    // Constructs the new element directly in its chunk slot.
+    template <typename... Args>
+    void emplaceFront(Args&&... args) {
+        Node<T>* chunk = head;
+        if (chunk == nullptr || chunk->isFull()) {
+            chunk = prependChunk();
         }
+        chunk->emplaceAt(0, std::forward<Args>(args)...);
         size++;
+        indexValid = false;
     }
 
-    bool remove(const T& data) {
-        if (head == nullptr) {
-            return false;
+    template <typename... Args>
+    void emplaceBack(Args&&... args) {
+        Node<T>* chunk = tail;
+        if (chunk == nullptr || chunk->isFull()) {
+            chunk = appendChunk();
         }
+        chunk->emplaceAt(chunk->count, std::forward<Args>(args)...);
+        size++;
+    }
 
-        if (head->data == data) {
-            Node<T>* temp = head;
-            head = head->next;
-            delete temp;
-            size--;
-            return true;
+    bool remove(const T& data) {
+        for (Node<T>* chunk = head; chunk != nullptr; chunk = chunk->next) {
+            if (removeFromChunk(chunk, data)) {
+                return true;
+            }
         }
+        return false;
+    }
 
-        Node<T>* current = head;
-        while (current->next != nullptr && !(current->next->data == data)) {
-            current = current->next;
+    // Removes data from the given chunk only, for callers that already know
+    // where the element lives. Costs at most one chunk scan.
+    bool removeFromChunk(Node<T>* chunk, const T& data) {
+        for (int i = 0; i < chunk->count; i++) {
+            if (chunk->at(i) == data) {
+                chunk->eraseAt(i);
+                size--;
+                rebalanceAfterErase(chunk);
+                indexValid = false;
+                return true;
+            }
         }
+        return false;
+    }
 
-        if (current->next != nullptr) {
-            Node<T>* temp = current->next;
-            current->next = temp->next;
-            delete temp;
-            size--;
-            return true;
-        }
+    // First chunk, for owners that walk the chunks themselves; follow
+    // Node::next from here.
+    Node<T>* frontChunk() const {
+        return head;
+    }
 
-        return false;
+    // Chunk holding the last element; after insertBack/emplaceBack this is
+    // where the new element lives.
+    Node<T>* backChunk() const {
+        return tail;
+    }
+
+    void setRelocationHandler(std::function<void(const T&, Node<T>*)> handler) {
+        onRelocate = std::move(handler);
     }
 
     bool find(const T& data) const {
-        Node<T>* current = head;
-        while (current != nullptr) {
-            if (current->data == data) {
-                return true;
+        for (const Node<T>* chunk = head; chunk != nullptr; chunk = chunk->next) {
+            for (int i = 0; i < chunk->count; i++) {
+                if (chunk->at(i) == data) {
+                    return true;
+                }
             }
-            current = current->next;
         }
         return false;
     }
 
+    // Stable bottom-up merge sort, O(n log n). Each chunk is sorted in
+    // place, then runs of chunks are merged pairwise as in a binary
+    // counter. Elements are moved, never copied, and the sort needs at most
+    // one chunk beyond the list itself. Already sorted stretches are
+    // relinked rather than moved.
+    template <typename Compare>
+    void sort(Compare comp) {
+        // pending[k] holds a sorted run of about 2^k chunks; higher levels
+        // hold earlier elements.
+        Run pending[64];
+        Node<T>* chunk = head;
+        while (chunk != nullptr) {
+            Node<T>* next = chunk->next;
+            chunk->prev = nullptr;
+            chunk->next = nullptr;
+            sortChunk(chunk, comp);
+
+            Run run(chunk, chunk);
+            int level = 0;
+            while (pending[level].head != nullptr) {
+                run = mergeRuns(pending[level], run, *this, comp);
+                pending[level] = Run();
+                level++;
+            }
+            pending[level] = run;
+            chunk = next;
+        }
+
+        Run result;
+        for (Run& run : pending) {
+            if (run.head != nullptr) {
+                result = result.head == nullptr ? run : mergeRuns(run, result, *this, comp);
+            }
+        }
+        adoptRun(result);
+    }
+
+    void sort() {
+        sort(std::less<T>());
+    }
+
+    // Moves every element of other into this list, in order. Both lists
+    // must already be sorted by comp; on ties this list's elements come
+    // first. Leaves other empty.
+    template <typename Compare>
+    void merge(List<T, Alloc>& other, Compare comp) {
+        if (this == &other || other.head == nullptr) {
+            return;
+        }
+        Run result = mergeRuns(Run(head, tail), Run(other.head, other.tail), other, comp);
+        size += other.size;
+        other.head = nullptr;
+        other.clear();
+        adoptRun(result);
+    }
+
+    void merge(List<T, Alloc>& other) {
+        merge(other, std::less<T>());
+    }
+
     int getSize() const {
         return size;
     }
@@ -102,42 +538,37 @@ public:
         return head == nullptr;
     }
 
+    // Destroys every chunk, then lets the allocator drop its storage in bulk
+    // (whole slabs for the default pool).
     void clear() {
         while (head != nullptr) {
             Node<T>* temp = head;
             head = head->next;
-            delete temp;
+            destroyChunk(temp);
         }
+        allocator.release();
+        tail = nullptr;
         size = 0;
+        chunkIndex.clear();
+        chunkStart.clear();
+        indexValid = true;
     }
 
     T& at(int index) {
-        if (index < 0 || index >= size) {
-            throw std::out_of_range("Index out of bounds");
-        }
-        Node<T>* current = head;
-        for (int i = 0; i < index; i++) {
-            current = current->next;
-        }
-        return current->data;
+        int slot;
+        Node<T>* chunk = locate(index, slot);
+        return chunk->at(slot);
     }
 
     const T& at(int index) const {
-        if (index < 0 || index >= size) {
-            throw std::out_of_range("Index out of bounds");
-        }
-        Node<T>* current = head;
-        for (int i = 0; i < index; i++) {
-            current = current->next;
-        }
-        return current->data;
+        int slot;
+        const Node<T>* chunk = locate(index, slot);
+        return chunk->at(slot);
     }
 
     void display() const {
-        Node<T>* current = head;
-        while (current != nullptr) {
-            std::cout << current->data << std::endl;
-            current = current->next;
+        for (const T& item : *this) {
+            std::cout << item << std::endl;
         }
     }
 };
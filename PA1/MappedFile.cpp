@@ -0,0 +1,55 @@
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile() : data(nullptr), size(0) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path, Access access) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    if (info.st_size == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    // A file read once can be read ahead aggressively and its pages dropped
+    // behind the reader. One that stays mapped is read in up front and
+    // kept, since its pages are read in place at random later.
+    madvise(mapping, info.st_size, access == READ_ONCE ? MADV_SEQUENTIAL : MADV_WILLNEED);
+
+    data = static_cast<const char*>(mapping);
+    size = info.st_size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data != nullptr) {
+        munmap(const_cast<char*>(data), size);
+        data = nullptr;
+    }
+    size = 0;
+}
+
+std::string_view MappedFile::contents() const {
+    return std::string_view(data, size);
+}
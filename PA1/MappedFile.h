@@ -0,0 +1,37 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// A whole file mapped read-only into memory. contents() views the mapping
+// directly, so readers can tokenize it without copying it first. The view
+// is valid until the MappedFile is closed or destroyed.
+class MappedFile {
+private:
+    const char* data;
+    std::size_t size;
+
+public:
+    // How the mapping will be read; passed on to the kernel as advice.
+    enum Access {
+        READ_ONCE,      // Front to back, once, e.g. by a loader
+        KEEP_MAPPED     // In place, in any order, for as long as it is open
+    };
+
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Returns false if the file cannot be opened. An empty file opens
+    // successfully with empty contents.
+    bool open(const std::string& path, Access access);
+    void close();
+
+    std::string_view contents() const;
+};
+
+#endif
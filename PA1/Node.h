@@ -1,15 +1,79 @@
 #ifndef NODE_H
 #define NODE_H
 
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// One chunk of an unrolled linked list. Each node stores up to CAPACITY
+// elements contiguously, so walking the list touches one heap block per
+// chunk instead of one per element. Slots [0, count) are constructed.
 template <typename T>
 class Node {
 public:
-    T data;
+    static const int CHUNK_BYTES = 512;
+    static const int CAPACITY =
+        sizeof(T) * 8 >= CHUNK_BYTES ? 8 : static_cast<int>(CHUNK_BYTES / sizeof(T));
+
     Node<T>* next;
+    Node<T>* prev;
+    int count;
+
+    Node() : next(nullptr), prev(nullptr), count(0) {}
+    ~Node() { clear(); }
+
+    Node(const Node<T>&) = delete;
+    Node<T>& operator=(const Node<T>&) = delete;
+
+    T& at(int i) {
+        return *reinterpret_cast<T*>(&slots[i]);
+    }
+
+    const T& at(int i) const {
+        return *reinterpret_cast<const T*>(&slots[i]);
+    }
+
+    bool isFull() const {
+        return count == CAPACITY;
+    }
+
+    // Constructs a new element at slot i, shifting [i, count) one slot right.
+    // The caller guarantees the chunk is not full.
+    template <typename... Args>
+    void emplaceAt(int i, Args&&... args) {
+        if (i == count) {
+            new (&slots[count]) T(std::forward<Args>(args)...);
+        } else {
+            // args may refer to an element of this chunk, such as
+            // insert(pos, *it), so build the value before anything moves
+            T value(std::forward<Args>(args)...);
+            for (int j = count; j > i; j--) {
+                new (&slots[j]) T(std::move(at(j - 1)));
+                at(j - 1).~T();
+            }
+            new (&slots[i]) T(std::move(value));
+        }
+        count++;
+    }
+
+    // Destroys the element at slot i, shifting (i, count) one slot left.
+    void eraseAt(int i) {
+        for (int j = i; j < count - 1; j++) {
+            at(j) = std::move(at(j + 1));
+        }
+        at(count - 1).~T();
+        count--;
+    }
+
+    void clear() {
+        for (int i = 0; i < count; i++) {
+            at(i).~T();
+        }
+        count = 0;
+    }
 
-    Node() : data(T()), next(nullptr) {}
-    Node(const T& newData) : data(newData), next(nullptr) {}
-    ~Node() = default;
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[CAPACITY];
 };
 
 #endif
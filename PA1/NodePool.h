@@ -0,0 +1,130 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Node allocators for List<T>. An allocator hands out raw, suitably aligned
+// storage for one N at a time; List constructs and destroys nodes in it.
+//
+//   void* allocate();          storage for one N
+//   void deallocate(void* p);  return storage obtained from allocate()
+//   void release();            called once every node has been destroyed
+
+// Slab/free-list pool: storage comes from slabs that start at one node and
+// double up to MAX_SLAB_NODES, so a short list only pays for the nodes it
+// uses. Freed nodes are recycled in O(1), and release() returns whole slabs
+// at once.
+template <typename N>
+class NodePool {
+private:
+    static const int FIRST_SLAB_NODES = 1;
+    static const int MAX_SLAB_NODES = 64;
+
+    union Slot {
+        Slot* nextFree;
+        typename std::aligned_storage<sizeof(N), alignof(N)>::type storage;
+    };
+
+    // Slabs are chained through a header placed before their slots
+    struct Slab {
+        Slab* next;
+        int capacity;
+
+        Slot* slots() {
+            return reinterpret_cast<Slot*>(reinterpret_cast<char*>(this) + headerBytes());
+        }
+
+        static std::size_t headerBytes() {
+            return (sizeof(Slab) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+        }
+    };
+
+    Slab* slabs;
+    Slot* freeList;
+    int unusedInSlab;
+
+public:
+    NodePool() : slabs(nullptr), freeList(nullptr), unusedInSlab(0) {}
+
+    ~NodePool() {
+        release();
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    NodePool(NodePool&& other) noexcept
+        : slabs(other.slabs), freeList(other.freeList), unusedInSlab(other.unusedInSlab) {
+        other.slabs = nullptr;
+        other.freeList = nullptr;
+        other.unusedInSlab = 0;
+    }
+
+    NodePool& operator=(NodePool&& other) noexcept {
+        if (this != &other) {
+            release();
+            std::swap(slabs, other.slabs);
+            std::swap(freeList, other.freeList);
+            std::swap(unusedInSlab, other.unusedInSlab);
+        }
+        return *this;
+    }
+
+    void* allocate() {
+        if (freeList != nullptr) {
+            Slot* slot = freeList;
+            freeList = slot->nextFree;
+            return slot;
+        }
+        if (unusedInSlab == 0) {
+            // Each new slab is twice the size of the last one
+            int capacity = slabs == nullptr ? FIRST_SLAB_NODES : slabs->capacity * 2;
+            if (capacity > MAX_SLAB_NODES) {
+                capacity = MAX_SLAB_NODES;
+            }
+            Slab* slab = static_cast<Slab*>(
+                ::operator new(Slab::headerBytes() + capacity * sizeof(Slot)));
+            slab->next = slabs;
+            slab->capacity = capacity;
+            slabs = slab;
+            unusedInSlab = capacity;
+        }
+        return &slabs->slots()[slabs->capacity - unusedInSlab--];
+    }
+
+    void deallocate(void* p) {
+        Slot* slot = static_cast<Slot*>(p);
+        slot->nextFree = freeList;
+        freeList = slot;
+    }
+
+    void release() {
+        while (slabs != nullptr) {
+            Slab* slab = slabs;
+            slabs = slabs->next;
+            ::operator delete(slab);
+        }
+        freeList = nullptr;
+        unusedInSlab = 0;
+    }
+};
+
+// One heap allocation per node, as List did before pooling.
+template <typename N>
+class HeapNodeAllocator {
+public:
+    void* allocate() {
+        return ::operator new(sizeof(N));
+    }
+
+    void deallocate(void* p) {
+        ::operator delete(p);
+    }
+
+    void release() {}
+};
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <iostream>
+#include <utility>
 
 class Player {
 public:
@@ -11,8 +12,8 @@ public:
 
     Player() : name(""), score(0) {}
 
-    Player(const std::string& playerName, int playerScore)
-        : name(playerName), score(playerScore) {}
+    Player(std::string playerName, int playerScore)
+        : name(std::move(playerName)), score(playerScore) {}
 
     Player(const Player& other) : name(other.name), score(other.score) {}
 
@@ -24,6 +25,16 @@ public:
         return *this;
     }
 
+    Player(Player&& other) noexcept : name(std::move(other.name)), score(other.score) {}
+
+    Player& operator=(Player&& other) noexcept {
+        if (this != &other) {
+            name = std::move(other.name);
+            score = other.score;
+        }
+        return *this;
+    }
+
     bool operator>(const Player& other) const {
         return score > other.score;
     }
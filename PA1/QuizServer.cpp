@@ -0,0 +1,258 @@
+#include "QuizServer.h"
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void reportError(const std::string& what) {
+    std::cerr << "Error: " << what << ": " << std::strerror(errno) << std::endl;
+}
+
+}
+
+QuizServer::QuizServer(const CommandCatalog& catalog, std::function<void(Player)> onGameFinished)
+    : catalog(catalog), onGameFinished(std::move(onGameFinished)), rng(std::random_device()()),
+      listenFd(-1), epollFd(-1), sessionsServed(0) {}
+
+QuizServer::~QuizServer() {
+    while (!connections.empty()) {
+        closeConnection(connections.begin()->first);
+    }
+    if (epollFd >= 0) {
+        close(epollFd);
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+    }
+}
+
+void QuizServer::stop() {
+    stopRequested = 1;
+}
+
+bool QuizServer::run(const std::string& socketPath) {
+    if (!openSocket(socketPath)) {
+        return false;
+    }
+    std::cout << "Quiz server listening on " << socketPath << std::endl;
+
+    epoll_event events[MAX_EVENTS];
+    while (!stopRequested) {
+        int ready = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            reportError("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < ready; i++) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptConnections();
+                continue;
+            }
+
+            std::unordered_map<int, std::unique_ptr<Connection> >::iterator it = connections.find(fd);
+            if (it == connections.end()) {
+                continue;
+            }
+            Connection& conn = *it->second;
+
+            if (events[i].events & EPOLLIN) {
+                handleReadable(conn);
+            } else if (events[i].events & EPOLLOUT) {
+                if (!flushOutput(conn) || (isDone(conn) && conn.output.empty())) {
+                    closeConnection(fd);
+                } else {
+                    updateInterest(conn, !conn.output.empty());
+                }
+            } else {
+                closeConnection(fd);
+            }
+        }
+    }
+
+    while (!connections.empty()) {
+        closeConnection(connections.begin()->first);
+    }
+    unlink(socketPath.c_str());
+    std::cout << "Quiz server stopped after " << sessionsServed << " finished games." << std::endl;
+    return true;
+}
+
+bool QuizServer::openSocket(const std::string& socketPath) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: socket path too long: " << socketPath << std::endl;
+        return false;
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        reportError("socket");
+        return false;
+    }
+
+    unlink(socketPath.c_str());
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        reportError("bind " + socketPath);
+        return false;
+    }
+    if (listen(listenFd, SOMAXCONN) < 0) {
+        reportError("listen");
+        return false;
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        reportError("epoll_create1");
+        return false;
+    }
+
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event) < 0) {
+        reportError("epoll_ctl");
+        return false;
+    }
+    return true;
+}
+
+void QuizServer::acceptConnections() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                reportError("accept");
+            }
+            return;
+        }
+
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            reportError("epoll_ctl");
+            close(fd);
+            continue;
+        }
+
+        Connection* conn = new Connection(fd, catalog, rng);
+        connections[fd] = std::unique_ptr<Connection>(conn);
+        conn->session.start(conn->output);
+        if (!flushOutput(*conn)) {
+            closeConnection(fd);
+        } else {
+            updateInterest(*conn, !conn->output.empty());
+        }
+    }
+}
+
+// Reads everything available, feeds complete lines to the session, and
+// queues its replies. Closes the connection once the game is over and the
+// last reply has been sent, or when the client goes away.
+void QuizServer::handleReadable(Connection& conn) {
+    bool peerClosed = false;
+    char buffer[4096];
+    while (true) {
+        ssize_t n = read(conn.fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            conn.input.append(buffer, n);
+        } else if (n == 0) {
+            peerClosed = true;
+            break;
+        } else if (errno == EINTR) {
+            continue;
+        } else {
+            peerClosed = errno != EAGAIN && errno != EWOULDBLOCK;
+            break;
+        }
+    }
+
+    size_t start = 0;
+    size_t newline;
+    while (!isDone(conn) && (newline = conn.input.find('\n', start)) != std::string::npos) {
+        size_t length = newline - start;
+        if (length > 0 && conn.input[newline - 1] == '\r') {
+            length--;
+        }
+        conn.session.handleInput(conn.input.substr(start, length), conn.output);
+        start = newline + 1;
+
+        if (conn.session.getState() == QuizSession::FINISHED) {
+            sessionsServed++;
+            onGameFinished(Player(conn.session.getPlayerName(), conn.session.getScore()));
+        }
+    }
+    conn.input.erase(0, start);
+    if (conn.input.size() > MAX_LINE_LENGTH) {
+        peerClosed = true;
+    }
+
+    if (!flushOutput(conn) || peerClosed || (isDone(conn) && conn.output.empty())) {
+        closeConnection(conn.fd);
+    } else {
+        updateInterest(conn, !conn.output.empty());
+    }
+}
+
+bool QuizServer::flushOutput(Connection& conn) {
+    size_t sent = 0;
+    while (sent < conn.output.size()) {
+        ssize_t n = send(conn.fd, conn.output.data() + sent, conn.output.size() - sent, MSG_NOSIGNAL);
+        if (n >= 0) {
+            sent += n;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    conn.output.erase(0, sent);
+    return true;
+}
+
+bool QuizServer::isDone(const Connection& conn) const {
+    return conn.session.getState() == QuizSession::FINISHED ||
+           conn.session.getState() == QuizSession::CANCELLED;
+}
+
+void QuizServer::updateInterest(Connection& conn, bool wantsWrite) {
+    if (conn.wantsWrite == wantsWrite) {
+        return;
+    }
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = wantsWrite ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+    event.data.fd = conn.fd;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, conn.fd, &event);
+    conn.wantsWrite = wantsWrite;
+}
+
+void QuizServer::closeConnection(int fd) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections.erase(fd);
+}
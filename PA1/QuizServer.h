@@ -0,0 +1,63 @@
+#ifndef QUIZ_SERVER_H
+#define QUIZ_SERVER_H
+
+#include "CommandCatalog.h"
+#include "Player.h"
+#include "QuizSession.h"
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+// Hosts many quiz sessions at once on a local Unix socket (Linux only).
+// A single epoll loop multiplexes every connection, so all sessions share
+// the read-only catalog without locking. Each connection speaks the same
+// line-based text as the console game and is closed when its game ends.
+class QuizServer {
+public:
+    QuizServer(const CommandCatalog& catalog, std::function<void(Player)> onGameFinished);
+    ~QuizServer();
+
+    QuizServer(const QuizServer&) = delete;
+    QuizServer& operator=(const QuizServer&) = delete;
+
+    // Serves until stop() is called (e.g. from a signal handler).
+    // Returns false if the socket could not be set up.
+    bool run(const std::string& socketPath);
+
+    static void stop();
+
+private:
+    struct Connection {
+        int fd;
+        QuizSession session;
+        std::string input;
+        std::string output;
+        bool wantsWrite;
+
+        Connection(int fd, const CommandCatalog& catalog, std::mt19937& rng)
+            : fd(fd), session(catalog, rng), wantsWrite(false) {}
+    };
+
+    static const int MAX_EVENTS = 256;
+    static const size_t MAX_LINE_LENGTH = 4096;
+
+    const CommandCatalog& catalog;
+    std::function<void(Player)> onGameFinished;
+    std::mt19937 rng;
+    int listenFd;
+    int epollFd;
+    std::unordered_map<int, std::unique_ptr<Connection> > connections;
+    long long sessionsServed;
+
+    bool openSocket(const std::string& socketPath);
+    void acceptConnections();
+    void handleReadable(Connection& conn);
+    bool flushOutput(Connection& conn);
+    bool isDone(const Connection& conn) const;
+    void updateInterest(Connection& conn, bool wantsWrite);
+    void closeConnection(int fd);
+};
+
+#endif
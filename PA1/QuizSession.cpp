@@ -0,0 +1,222 @@
+#include "QuizSession.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+
+namespace {
+
+// Adds the lifetime of the timer to *total, or does nothing (not even read
+// the clock) when total is null.
+class PhaseTimer {
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    long long* total;
+    Clock::time_point start;
+
+public:
+    explicit PhaseTimer(long long* total) : total(total) {
+        if (total != nullptr) {
+            start = Clock::now();
+        }
+    }
+
+    ~PhaseTimer() {
+        if (total != nullptr) {
+            *total += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        }
+    }
+};
+
+// Appends value in decimal. Goes through a stack buffer, so unlike
+// std::to_string it builds no temporary string.
+void appendNumber(std::string& out, int value) {
+    char digits[12];
+    char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    out.append(digits, end);
+}
+
+}
+
+QuizSession::QuizSession(const CommandCatalog& catalog, std::mt19937& rng)
+    : catalog(catalog), rng(rng), timings(nullptr), state(AWAITING_NAME), score(0),
+      currentQuestion(0) {}
+
+void QuizSession::start(std::string& out) {
+    out += "Enter your name: ";
+}
+
+void QuizSession::handleInput(const std::string& line, std::string& out) {
+    if (state == AWAITING_NAME) {
+        if (line.empty()) {
+            out += "Invalid name. Game cancelled.\n";
+            state = CANCELLED;
+            return;
+        }
+        bool picked;
+        {
+            PhaseTimer timer(timings != nullptr ? &timings->generationNs : nullptr);
+            picked = pickQuestions();
+        }
+        if (!picked) {
+            out += "Not enough commands in the database. Game cancelled.\n";
+            state = CANCELLED;
+            return;
+        }
+        playerName = line;
+        state = AWAITING_ANSWER;
+
+        out += "\n=== GAME START ===\n";
+        out += "Hello ";
+        out += playerName;
+        out += "! Let's begin the quiz.\n\n";
+        askQuestion(out);
+    } else if (state == AWAITING_ANSWER) {
+        handleAnswer(line, out);
+    }
+}
+
+QuizSession::State QuizSession::getState() const {
+    return state;
+}
+
+const std::string& QuizSession::getPlayerName() const {
+    return playerName;
+}
+
+int QuizSession::getScore() const {
+    return score;
+}
+
+int QuizSession::getCorrectChoice() const {
+    for (int j = 0; j < CHOICES_PER_QUESTION; j++) {
+        if (choices[j].id == questions[currentQuestion].id) {
+            return j + 1;
+        }
+    }
+    return 0;
+}
+
+void QuizSession::setTimings(Timings* timings) {
+    this->timings = timings;
+}
+
+// Draws QUESTIONS_PER_GAME distinct commands from one catalog version and
+// keeps copies of them, and a hold on their text, so the game does not
+// depend on that version once it has started. Duplicates are rejected by
+// Command::id against the tiny array of picks, so a game never touches the
+// whole catalog.
+bool QuizSession::pickQuestions() {
+    CommandCatalog::ReadGuard version = catalog.read();
+    if (version->getSize() < QUESTIONS_PER_GAME) {
+        return false;
+    }
+
+    questionText = version->getText();
+    std::uniform_int_distribution<int> dis(0, version->getSize() - 1);
+    int filled = 0;
+    while (filled < QUESTIONS_PER_GAME) {
+        const Command& candidate = version->at(dis(rng));
+        if (!containsId(questions.data(), filled, candidate.id)) {
+            questions[filled++] = candidate;
+        }
+    }
+    return true;
+}
+
+// Fills choices with the correct command plus two distinct distractors in
+// random order. Distractors come from the latest catalog version and are
+// told apart by Command::id, which stays the same across versions, so the
+// correct command is never offered twice. Copying a Command copies two
+// views, so nothing is allocated; choiceText keeps their text alive. Should
+// the catalog have shrunk below CHOICES_PER_QUESTION, this game's own
+// questions serve as distractors.
+void QuizSession::pickChoices(const Command& correct) {
+    choices.fill(correct);
+    CommandCatalog::ReadGuard version = catalog.read();
+    choiceText = version->getText();
+    bool fromCatalog = version->getSize() >= CHOICES_PER_QUESTION;
+    std::uniform_int_distribution<int> dis(0, (fromCatalog ? version->getSize() : QUESTIONS_PER_GAME) - 1);
+
+    int filled = 1;
+    while (filled < CHOICES_PER_QUESTION) {
+        const Command& candidate = fromCatalog ? version->at(dis(rng)) : questions[dis(rng)];
+        if (!containsId(choices.data(), filled, candidate.id)) {
+            choices[filled++] = candidate;
+        }
+    }
+
+    std::shuffle(choices.begin(), choices.end(), rng);
+}
+
+bool QuizSession::containsId(const Command* picked, int count, int id) {
+    for (int i = 0; i < count; i++) {
+        if (picked[i].id == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void QuizSession::askQuestion(std::string& out) {
+    PhaseTimer timer(timings != nullptr ? &timings->generationNs : nullptr);
+    const Command& question = questions[currentQuestion];
+    pickChoices(question);
+
+    out += "Question ";
+    appendNumber(out, currentQuestion + 1);
+    out += "/";
+    appendNumber(out, QUESTIONS_PER_GAME);
+    out += "\n";
+    out += "Command: ";
+    out += question.command;
+    out += "\n";
+    out += "What does this command do?\n";
+    for (int j = 0; j < CHOICES_PER_QUESTION; j++) {
+        appendNumber(out, j + 1);
+        out += ". ";
+        out += choices[j].description;
+        out += "\n";
+    }
+    out += "Your answer (1-3): ";
+}
+
+void QuizSession::handleAnswer(const std::string& line, std::string& out) {
+    {
+        PhaseTimer timer(timings != nullptr ? &timings->scoringNs : nullptr);
+        size_t start = line.find_first_not_of(" \t\r");
+        size_t end = line.find_last_not_of(" \t\r");
+        if (start == std::string::npos || start != end ||
+            line[start] < '1' || line[start] > '0' + CHOICES_PER_QUESTION) {
+            out += "Invalid input. Please enter 1, 2, or 3: ";
+            return;
+        }
+        int answer = line[start] - '0';
+
+        const Command& currentCommand = questions[currentQuestion];
+        if (choices[answer - 1].id == currentCommand.id) {
+            out += "Correct! +";
+            appendNumber(out, currentCommand.points);
+            out += " points\n";
+            score += currentCommand.points;
+        } else {
+            out += "Wrong! The correct answer was: ";
+            out += currentCommand.description;
+            out += "\n";
+        }
+        out += "Current score: ";
+        appendNumber(out, score);
+        out += "\n\n";
+    }
+
+    if (++currentQuestion < QUESTIONS_PER_GAME) {
+        askQuestion(out);
+    } else {
+        out += "=== GAME OVER ===\n";
+        out += playerName;
+        out += ", your final score is: ";
+        appendNumber(out, score);
+        out += " points\n";
+        state = FINISHED;
+    }
+}
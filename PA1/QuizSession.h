@@ -0,0 +1,73 @@
+#ifndef QUIZ_SESSION_H
+#define QUIZ_SESSION_H
+
+#include "CommandCatalog.h"
+#include <array>
+#include <random>
+#include <string>
+
+// One player's pass through the quiz as a non-blocking state machine.
+// The owner feeds it one line of input at a time and sends whatever text it
+// appends to `out`, so the same flow drives the console game and every
+// connection of the quiz server. The session reads published catalog
+// versions and keeps copies of its questions, so admins may change the
+// catalog while games are running.
+class QuizSession {
+public:
+    enum State {
+        AWAITING_NAME,
+        AWAITING_ANSWER,
+        FINISHED,
+        CANCELLED
+    };
+
+    static const int QUESTIONS_PER_GAME = 20;
+    static const int CHOICES_PER_QUESTION = 3;
+
+    // Time spent in each phase of the game, accumulated while attached with
+    // setTimings(). Generation covers picking questions and choices and
+    // formatting them; scoring covers checking answers.
+    struct Timings {
+        long long generationNs;
+        long long scoringNs;
+
+        Timings() : generationNs(0), scoringNs(0) {}
+    };
+
+    QuizSession(const CommandCatalog& catalog, std::mt19937& rng);
+
+    void start(std::string& out);
+    void handleInput(const std::string& line, std::string& out);
+
+    State getState() const;
+    const std::string& getPlayerName() const;
+    int getScore() const;
+    // The correct answer (1-based) to the question being asked. Only
+    // meaningful while AWAITING_ANSWER; used by bot players.
+    int getCorrectChoice() const;
+
+    void setTimings(Timings* timings);
+
+private:
+    const CommandCatalog& catalog;
+    std::mt19937& rng;
+    Timings* timings;
+    State state;
+    std::string playerName;
+    int score;
+    int currentQuestion;
+    std::array<Command, QUESTIONS_PER_GAME> questions;
+    std::array<Command, CHOICES_PER_QUESTION> choices;
+    // Keep the text of the versions the questions and choices came from.
+    CommandCatalog::TextRef questionText;
+    CommandCatalog::TextRef choiceText;
+
+    bool pickQuestions();
+    void pickChoices(const Command& correct);
+    // Whether one of the first count commands in picked has this id.
+    static bool containsId(const Command* picked, int count, int id);
+    void askQuestion(std::string& out);
+    void handleAnswer(const std::string& line, std::string& out);
+};
+
+#endif
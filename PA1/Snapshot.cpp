@@ -0,0 +1,182 @@
+#include "Snapshot.h"
+#include <cstring>
+
+namespace {
+
+const char MAGIC[8] = {'L', 'C', 'M', 'G', 'S', 'N', 'A', 'P'};
+
+// magic, version, command count, player count, text bytes, checksum
+const std::size_t HEADER_BYTES = 8 + 4 * 4 + 8;
+// name offset, name length, description offset, description length, points
+const std::size_t COMMAND_RECORD_BYTES = 5 * 4;
+// name offset, name length, score
+const std::size_t PLAYER_RECORD_BYTES = 3 * 4;
+
+void appendU32(std::string& out, std::uint32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendU64(std::string& out, std::uint64_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+std::uint32_t readU32(const char* at) {
+    std::uint32_t value;
+    std::memcpy(&value, at, sizeof(value));
+    return value;
+}
+
+std::uint64_t readU64(const char* at) {
+    std::uint64_t value;
+    std::memcpy(&value, at, sizeof(value));
+    return value;
+}
+
+// FNV-1a style hash taken a word at a time, with a shift to fold high bits
+// back down. Catches truncation and stray writes, not tampering.
+std::uint64_t checksum(std::string_view bytes) {
+    const std::uint64_t PRIME = 0x100000001b3ULL;
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    std::size_t i = 0;
+    for (; i + 8 <= bytes.size(); i += 8) {
+        hash = (hash ^ readU64(bytes.data() + i)) * PRIME;
+        hash ^= hash >> 29;
+    }
+    for (; i < bytes.size(); i++) {
+        hash = (hash ^ static_cast<unsigned char>(bytes[i])) * PRIME;
+    }
+    return hash;
+}
+
+bool inText(std::uint32_t offset, std::uint32_t length, std::uint32_t textBytes) {
+    return offset <= textBytes && length <= textBytes - offset;
+}
+
+}
+
+Snapshot::Builder::Builder() : commandCount(0), playerCount(0) {}
+
+std::uint32_t Snapshot::Builder::storeText(std::string_view value) {
+    std::uint32_t offset = static_cast<std::uint32_t>(text.size());
+    text.append(value.data(), value.size());
+    return offset;
+}
+
+void Snapshot::Builder::addCommand(const Command& cmd) {
+    appendU32(commandRecords, storeText(cmd.command));
+    appendU32(commandRecords, static_cast<std::uint32_t>(cmd.command.size()));
+    appendU32(commandRecords, storeText(cmd.description));
+    appendU32(commandRecords, static_cast<std::uint32_t>(cmd.description.size()));
+    appendU32(commandRecords, static_cast<std::uint32_t>(cmd.points));
+    commandCount++;
+}
+
+void Snapshot::Builder::addPlayer(std::string_view name, int score) {
+    appendU32(playerRecords, storeText(name));
+    appendU32(playerRecords, static_cast<std::uint32_t>(name.size()));
+    appendU32(playerRecords, static_cast<std::uint32_t>(score));
+    playerCount++;
+}
+
+std::string Snapshot::Builder::finish() const {
+    std::string body;
+    body.reserve(commandRecords.size() + playerRecords.size() + text.size());
+    body += commandRecords;
+    body += playerRecords;
+    body += text;
+
+    std::string out;
+    out.reserve(HEADER_BYTES + body.size());
+    out.append(MAGIC, sizeof(MAGIC));
+    appendU32(out, FORMAT_VERSION);
+    appendU32(out, commandCount);
+    appendU32(out, playerCount);
+    appendU32(out, static_cast<std::uint32_t>(text.size()));
+    appendU64(out, checksum(body));
+    out += body;
+    return out;
+}
+
+Snapshot::Snapshot()
+    : commandRecords(nullptr), playerRecords(nullptr), text(nullptr),
+      commandCount(0), playerCount(0), textBytes(0) {}
+
+bool Snapshot::open(const std::string& path) {
+    if (!file.open(path, MappedFile::KEEP_MAPPED)) {
+        return false;
+    }
+    std::string_view bytes = file.contents();
+    if (bytes.size() < HEADER_BYTES || std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0 ||
+        readU32(bytes.data() + 8) != FORMAT_VERSION) {
+        file.close();
+        return false;
+    }
+
+    std::uint32_t commands = readU32(bytes.data() + 12);
+    std::uint32_t players = readU32(bytes.data() + 16);
+    std::uint32_t textSize = readU32(bytes.data() + 20);
+    std::uint64_t expected = static_cast<std::uint64_t>(HEADER_BYTES) +
+                             static_cast<std::uint64_t>(commands) * COMMAND_RECORD_BYTES +
+                             static_cast<std::uint64_t>(players) * PLAYER_RECORD_BYTES + textSize;
+    if (expected != bytes.size() || readU64(bytes.data() + 24) != checksum(bytes.substr(HEADER_BYTES))) {
+        file.close();
+        return false;
+    }
+
+    const char* commandStart = bytes.data() + HEADER_BYTES;
+    const char* playerStart = commandStart + static_cast<std::size_t>(commands) * COMMAND_RECORD_BYTES;
+    const char* textStart = playerStart + static_cast<std::size_t>(players) * PLAYER_RECORD_BYTES;
+
+    // Every view handed out later must stay inside the text section.
+    for (std::uint32_t i = 0; i < commands; i++) {
+        const char* record = commandStart + i * COMMAND_RECORD_BYTES;
+        if (!inText(readU32(record), readU32(record + 4), textSize) ||
+            !inText(readU32(record + 8), readU32(record + 12), textSize)) {
+            file.close();
+            return false;
+        }
+    }
+    for (std::uint32_t i = 0; i < players; i++) {
+        const char* record = playerStart + i * PLAYER_RECORD_BYTES;
+        if (!inText(readU32(record), readU32(record + 4), textSize)) {
+            file.close();
+            return false;
+        }
+    }
+
+    commandRecords = commandStart;
+    playerRecords = playerStart;
+    text = textStart;
+    commandCount = commands;
+    playerCount = players;
+    textBytes = textSize;
+    return true;
+}
+
+int Snapshot::getCommandCount() const {
+    return static_cast<int>(commandCount);
+}
+
+Command Snapshot::commandAt(int index) const {
+    const char* record = commandRecords + index * COMMAND_RECORD_BYTES;
+    return Command(textAt(readU32(record), readU32(record + 4)),
+                   textAt(readU32(record + 8), readU32(record + 12)),
+                   static_cast<int>(readU32(record + 16)));
+}
+
+int Snapshot::getPlayerCount() const {
+    return static_cast<int>(playerCount);
+}
+
+std::string_view Snapshot::playerNameAt(int index) const {
+    const char* record = playerRecords + index * PLAYER_RECORD_BYTES;
+    return textAt(readU32(record), readU32(record + 4));
+}
+
+int Snapshot::playerScoreAt(int index) const {
+    return static_cast<int>(readU32(playerRecords + index * PLAYER_RECORD_BYTES + 8));
+}
+
+std::string_view Snapshot::textAt(std::uint32_t offset, std::uint32_t length) const {
+    return std::string_view(text + offset, length);
+}
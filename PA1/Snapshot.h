@@ -0,0 +1,74 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "Command.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Binary image of the commands and the leaderboard, written next to the CSV
+// files so startup can skip parsing them. Layout (host byte order):
+//
+//   header   magic "LCMGSNAP", format version, record counts, text size,
+//            checksum of everything after the header
+//   commands fixed-width records: name offset/length, description
+//            offset/length, points
+//   players  fixed-width records: name offset/length, score, in rank order
+//   text     every name and description, back to back
+//
+// A Snapshot maps the file and is used in place: commandAt() returns
+// Commands whose views point into the mapping, so they stay valid for as
+// long as the Snapshot is open.
+class Snapshot {
+public:
+    static const std::uint32_t FORMAT_VERSION = 1;
+
+    // Accumulates records, then encodes the whole file at once.
+    class Builder {
+    private:
+        std::string commandRecords;
+        std::string playerRecords;
+        std::string text;
+        std::uint32_t commandCount;
+        std::uint32_t playerCount;
+
+        std::uint32_t storeText(std::string_view value);
+
+    public:
+        Builder();
+
+        void addCommand(const Command& cmd);
+        void addPlayer(std::string_view name, int score);
+        std::string finish() const;
+    };
+
+    Snapshot();
+
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    // Maps the file and checks its header, bounds and checksum. Returns
+    // false for a missing, truncated, corrupt or other-version file.
+    bool open(const std::string& path);
+
+    int getCommandCount() const;
+    Command commandAt(int index) const;
+
+    int getPlayerCount() const;
+    std::string_view playerNameAt(int index) const;
+    int playerScoreAt(int index) const;
+
+private:
+    MappedFile file;
+    const char* commandRecords;
+    const char* playerRecords;
+    const char* text;
+    std::uint32_t commandCount;
+    std::uint32_t playerCount;
+    std::uint32_t textBytes;
+
+    std::string_view textAt(std::uint32_t offset, std::uint32_t length) const;
+};
+
+#endif
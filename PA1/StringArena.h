@@ -0,0 +1,62 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Append-only storage for strings that live as long as their owner. Text is
+// copied into large blocks and handed back as string_views; blocks are never
+// moved or freed before the arena is, so every view stays valid.
+class StringArena {
+private:
+    static const std::size_t BLOCK_BYTES = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]> > blocks;
+    char* cursor;
+    std::size_t remaining;
+    std::size_t used;
+
+    char* reserve(std::size_t bytes) {
+        if (bytes > remaining) {
+            // Oversized strings get a block of their own so the current
+            // block keeps its free space.
+            std::size_t blockBytes = bytes > BLOCK_BYTES / 4 ? bytes : BLOCK_BYTES;
+            blocks.emplace_back(new char[blockBytes]);
+            if (blockBytes != BLOCK_BYTES) {
+                return blocks.back().get();
+            }
+            cursor = blocks.back().get();
+            remaining = BLOCK_BYTES;
+        }
+        char* start = cursor;
+        cursor += bytes;
+        remaining -= bytes;
+        return start;
+    }
+
+public:
+    StringArena() : cursor(nullptr), remaining(0), used(0) {}
+
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+
+    std::string_view store(std::string_view text) {
+        if (text.empty()) {
+            return std::string_view();
+        }
+        char* start = reserve(text.size());
+        std::memcpy(start, text.data(), text.size());
+        used += text.size();
+        return std::string_view(start, text.size());
+    }
+
+    // Bytes of text stored so far.
+    std::size_t getSize() const {
+        return used;
+    }
+};
+
+#endif
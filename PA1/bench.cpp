@@ -0,0 +1,434 @@
+/*
+ * List<T> benchmark - compares the unrolled List<T> against std::vector,
+ * std::list and std::forward_list on the operations Game relies on, for
+ * int and Command elements and sizes from 10 up to 10^7.
+ * Build and run with: make bench
+ * Or run directly: ./list_bench [max_size]
+ *
+ * Every line reports time and heap allocations per operation. Small sizes
+ * are repeated over several containers so each timing covers enough work;
+ * O(n) lookups and removals are capped so large sizes finish. Command runs
+ * stop at 10^6 elements to keep memory use bounded.
+*/
+
+#include "Command.h"
+#include "List.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <forward_list>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <malloc.h>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Every heap allocation in the process goes through these, so each timed
+// section can also report how many allocations it performed.
+static long long allocationCount = 0;
+
+// GCC 12 flags free() on memory from the replaced operator new once the
+// pair is inlined into container code; the pair matches, so it is noise.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void* operator new(std::size_t bytes) {
+    allocationCount++;
+    void* p = std::malloc(bytes ? bytes : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#pragma GCC diagnostic pop
+
+namespace {
+
+typedef std::chrono::high_resolution_clock Clock;
+
+const int DEFAULT_MAX_SIZE = 10000000;
+const int MAX_COMMAND_SIZE = 1000000;
+// Sizes below this are built this many elements' worth of times over.
+const int MIN_ELEMENTS_PER_TIMING = 100000;
+// Rough number of elements O(n) lookups and removals may visit per line.
+const long long SCAN_BUDGET = 20000000;
+const int PROBES = 10000;
+// Front insertion is quadratic for a vector; larger sizes are skipped.
+const int MAX_VECTOR_FRONT_SIZE = 10000;
+
+// Keeps results observable so the optimizer cannot drop the timed loops.
+volatile long long sink = 0;
+
+// Times one section and counts the allocations made inside it.
+class Section {
+private:
+    Clock::time_point start;
+    long long allocsAtStart;
+
+public:
+    Section() : start(Clock::now()), allocsAtStart(allocationCount) {}
+
+    double nsPerOp(long long ops) const {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ops;
+    }
+
+    double allocsPerOp(long long ops) const {
+        return static_cast<double>(allocationCount - allocsAtStart) / ops;
+    }
+};
+
+void report(const std::string& op, const std::string& container, int n,
+            const Section& section, long long ops) {
+    double ns = section.nsPerOp(ops);
+    double allocs = section.allocsPerOp(ops);
+    std::cout << std::left << std::setw(12) << op
+              << std::setw(19) << container
+              << std::right << std::setw(10) << n
+              << std::setw(14) << std::fixed << std::setprecision(2) << ns << " ns/op"
+              << std::setw(10) << std::setprecision(3) << allocs << " allocs/op"
+              << std::endl;
+}
+
+std::vector<int> randomIndices(int n, int count) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> dis(0, n - 1);
+    std::vector<int> indices(count);
+    for (int& i : indices) {
+        i = dis(gen);
+    }
+    return indices;
+}
+
+// Elements 0..n-1 of each type. Command names are fixed-width so they sort
+// in the same order as their numbers; their text lives in `text`.
+void makeValues(int n, std::vector<int>& values, std::string&) {
+    values.resize(n);
+    for (int i = 0; i < n; i++) {
+        values[i] = i;
+    }
+}
+
+void makeValues(int n, std::vector<Command>& values, std::string& text) {
+    const int WIDTH = 10;
+    std::string_view description("Synthetic command used by the benchmark");
+    text.assign(static_cast<std::size_t>(n) * WIDTH, '0');
+    values.resize(n);
+    for (int i = 0; i < n; i++) {
+        char* name = &text[static_cast<std::size_t>(i) * WIDTH];
+        name[0] = 'c';
+        for (int digit = WIDTH - 1, rest = i; rest > 0; digit--, rest /= 10) {
+            name[digit] = static_cast<char>('0' + rest % 10);
+        }
+        values[i] = Command(std::string_view(name, WIDTH), description, i);
+    }
+}
+
+long long weigh(int value) {
+    return value;
+}
+
+long long weigh(const Command& cmd) {
+    return cmd.points;
+}
+
+struct ElementLess {
+    bool operator()(int a, int b) const {
+        return a < b;
+    }
+
+    bool operator()(const Command& a, const Command& b) const {
+        return a.command < b.command;
+    }
+};
+
+// One set of overloads per container, so a single benchmark body drives
+// them all with each container's idiomatic operations.
+template <typename T, typename A>
+void fillBack(List<T, A>& c, const std::vector<T>& values) {
+    for (const T& value : values) {
+        c.insertBack(value);
+    }
+}
+
+template <typename T>
+void fillBack(std::vector<T>& c, const std::vector<T>& values) {
+    for (const T& value : values) {
+        c.push_back(value);
+    }
+}
+
+template <typename T>
+void fillBack(std::list<T>& c, const std::vector<T>& values) {
+    for (const T& value : values) {
+        c.push_back(value);
+    }
+}
+
+template <typename T>
+void fillBack(std::forward_list<T>& c, const std::vector<T>& values) {
+    typename std::forward_list<T>::iterator last = c.before_begin();
+    for (const T& value : values) {
+        last = c.insert_after(last, value);
+    }
+}
+
+template <typename T, typename A>
+void fillFront(List<T, A>& c, const std::vector<T>& values) {
+    for (const T& value : values) {
+        c.insertFront(value);
+    }
+}
+
+template <typename T>
+void fillFront(std::vector<T>& c, const std::vector<T>& values) {
+    for (const T& value : values) {
+        c.insert(c.begin(), value);
+    }
+}
+
+template <typename T>
+void fillFront(std::list<T>& c, const std::vector<T>& values) {
+    for (const T& value : values) {
+        c.push_front(value);
+    }
+}
+
+template <typename T>
+void fillFront(std::forward_list<T>& c, const std::vector<T>& values) {
+    for (const T& value : values) {
+        c.push_front(value);
+    }
+}
+
+template <typename T, typename A>
+bool contains(const List<T, A>& c, const T& value) {
+    return c.find(value);
+}
+
+template <typename C, typename T>
+bool contains(const C& c, const T& value) {
+    return std::find(c.begin(), c.end(), value) != c.end();
+}
+
+template <typename T, typename A>
+const T& valueAt(const List<T, A>& c, int index) {
+    return c.at(index);
+}
+
+template <typename T>
+const T& valueAt(const std::vector<T>& c, int index) {
+    return c[index];
+}
+
+// std::list and std::forward_list have no random access; walk from the
+// front like the original List did.
+template <typename C>
+const typename C::value_type& valueAt(const C& c, int index) {
+    return *std::next(c.begin(), index);
+}
+
+template <typename T, typename A>
+bool hasFastAt(const List<T, A>&) {
+    return true;
+}
+
+template <typename T>
+bool hasFastAt(const std::vector<T>&) {
+    return true;
+}
+
+template <typename C>
+bool hasFastAt(const C&) {
+    return false;
+}
+
+template <typename T, typename A>
+void removeValue(List<T, A>& c, const T& value) {
+    c.remove(value);
+}
+
+template <typename C, typename T>
+void removeValue(C& c, const T& value) {
+    typename C::iterator it = std::find(c.begin(), c.end(), value);
+    if (it != c.end()) {
+        c.erase(it);
+    }
+}
+
+template <typename T>
+void removeValue(std::forward_list<T>& c, const T& value) {
+    typename std::forward_list<T>::iterator before = c.before_begin();
+    for (typename std::forward_list<T>::iterator it = c.begin(); it != c.end(); before = it++) {
+        if (*it == value) {
+            c.erase_after(before);
+            return;
+        }
+    }
+}
+
+template <typename T, typename A>
+void sortValues(List<T, A>& c) {
+    c.sort(ElementLess());
+}
+
+template <typename T>
+void sortValues(std::vector<T>& c) {
+    std::stable_sort(c.begin(), c.end(), ElementLess());
+}
+
+template <typename T>
+void sortValues(std::list<T>& c) {
+    c.sort(ElementLess());
+}
+
+template <typename T>
+void sortValues(std::forward_list<T>& c) {
+    c.sort(ElementLess());
+}
+
+template <typename C>
+bool isQuadraticAtFront(const C&) {
+    return false;
+}
+
+template <typename T>
+bool isQuadraticAtFront(const std::vector<T>&) {
+    return true;
+}
+
+template <typename C, typename T>
+void benchContainer(const std::string& name, const std::vector<T>& values,
+                    const std::vector<T>& shuffled, const std::vector<int>& probes) {
+    int n = static_cast<int>(values.size());
+    int reps = std::max(1, MIN_ELEMENTS_PER_TIMING / n);
+    long long elements = static_cast<long long>(reps) * n;
+
+    std::vector<C> built(reps);
+    Section section;
+    for (C& c : built) {
+        fillBack(c, values);
+    }
+    report("insertBack", name, n, section, elements);
+
+    section = Section();
+    long long sum = 0;
+    for (const C& c : built) {
+        for (const T& value : c) {
+            sum += weigh(value);
+        }
+    }
+    sink += sum;
+    report("traverse", name, n, section, elements);
+
+    std::vector<C> copies;
+    copies.reserve(reps);
+    section = Section();
+    for (const C& c : built) {
+        copies.push_back(c);
+    }
+    report("copy", name, n, section, elements);
+    copies.clear();
+
+    int lookups = static_cast<int>(probes.size());
+    if (!hasFastAt(built[0])) {
+        lookups = static_cast<int>(std::max(1LL, std::min<long long>(lookups, SCAN_BUDGET / n)));
+    }
+    section = Section();
+    for (int i = 0; i < lookups; i++) {
+        sink += weigh(valueAt(built[i % reps], probes[i]));
+    }
+    report("at", name, n, section, lookups);
+
+    int finds = static_cast<int>(std::max(1LL, std::min<long long>(probes.size(), SCAN_BUDGET / n)));
+    section = Section();
+    for (int i = 0; i < finds; i++) {
+        sink += contains(built[i % reps], values[probes[i]]);
+    }
+    report("find", name, n, section, finds);
+
+    // Removes elements from the middle of every container by value.
+    int removals = static_cast<int>(std::max(1LL, std::min<long long>(std::min(n / 2, 1000),
+                                                                      SCAN_BUDGET / elements)));
+    section = Section();
+    for (C& c : built) {
+        for (int i = 0; i < removals; i++) {
+            removeValue(c, values[n / 2 + i]);
+        }
+    }
+    report("remove-mid", name, n, section, static_cast<long long>(reps) * removals);
+    built.clear();
+
+    std::vector<C> front(reps);
+    if (!isQuadraticAtFront(front[0]) || n <= MAX_VECTOR_FRONT_SIZE) {
+        section = Section();
+        for (C& c : front) {
+            fillFront(c, values);
+        }
+        report("insertFront", name, n, section, elements);
+    }
+    front.clear();
+
+    std::vector<C> unsorted(reps);
+    for (C& c : unsorted) {
+        fillBack(c, shuffled);
+    }
+    section = Section();
+    for (C& c : unsorted) {
+        sortValues(c);
+    }
+    report("sort", name, n, section, elements);
+    unsorted.clear();
+
+    // Freed nodes otherwise sit in malloc's free lists in whatever order the
+    // sort left them, and the next container would get scattered nodes.
+    malloc_trim(0);
+}
+
+template <typename T>
+void runSuite(const std::string& typeName, int maxSize) {
+    std::cout << "=== List<T> benchmark (element type: " << typeName << ") ===" << std::endl;
+    for (int n = 10; n <= maxSize; n *= 10) {
+        std::cout << std::endl;
+        std::vector<T> values;
+        std::string text;
+        makeValues(n, values, text);
+        std::vector<T> shuffled(values);
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(7));
+        std::vector<int> probes = randomIndices(n, PROBES);
+
+        benchContainer<List<T>, T>("List", values, shuffled, probes);
+        benchContainer<List<T, HeapNodeAllocator<Node<T> > >, T>("List(heap)", values, shuffled, probes);
+        benchContainer<std::vector<T>, T>("std::vector", values, shuffled, probes);
+        benchContainer<std::list<T>, T>("std::list", values, shuffled, probes);
+        benchContainer<std::forward_list<T>, T>("std::forward_list", values, shuffled, probes);
+    }
+    std::cout << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int maxSize = argc > 1 ? std::atoi(argv[1]) : DEFAULT_MAX_SIZE;
+    if (maxSize < 10) {
+        std::cerr << "Usage: " << argv[0] << " [max_size]" << std::endl;
+        return 1;
+    }
+
+    runSuite<int>("int", maxSize);
+    runSuite<Command>("Command", std::min(maxSize, MAX_COMMAND_SIZE));
+    return 0;
+}
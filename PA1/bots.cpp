@@ -0,0 +1,159 @@
+/*
+ * Headless quiz load test - bot players play complete games through
+ * QuizSession, with no console or sockets involved, and the run reports
+ * games per second and where the time per question goes.
+ * Usage: ./quiz_bots [games] [threads] [seed] [accuracy_percent] [players]
+ *
+ * Every thread seeds its own generator from the base seed, so a run with
+ * the same arguments plays the same games and ends with the same
+ * leaderboard.
+*/
+
+#include "CommandCatalog.h"
+#include "Leaderboard.h"
+#include "QuizSession.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct BotStats {
+    long long games;
+    long long questions;
+    long long totalScore;
+    long long leaderboardNs;
+    QuizSession::Timings timings;
+
+    BotStats() : games(0), questions(0), totalScore(0), leaderboardNs(0) {}
+};
+
+// A bot answers correctly with probability `accuracy`, otherwise it picks
+// one of the wrong choices at random.
+std::string chooseAnswer(const QuizSession& session, double accuracy, std::mt19937& rng) {
+    int correct = session.getCorrectChoice();
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    if (coin(rng) < accuracy) {
+        return std::to_string(correct);
+    }
+    std::uniform_int_distribution<int> wrong(1, QuizSession::CHOICES_PER_QUESTION - 1);
+    int answer = wrong(rng);
+    return std::to_string(answer >= correct ? answer + 1 : answer);
+}
+
+void runBots(const CommandCatalog& catalog, Leaderboard& leaderboard, std::mutex& leaderboardLock,
+             int games, unsigned seed, double accuracy, int players, BotStats& stats) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> pickPlayer(0, players - 1);
+    std::string output;
+
+    for (int g = 0; g < games; g++) {
+        QuizSession session(catalog, rng);
+        session.setTimings(&stats.timings);
+        output.clear();
+        session.start(output);
+        session.handleInput("bot" + std::to_string(pickPlayer(rng)), output);
+
+        while (session.getState() == QuizSession::AWAITING_ANSWER) {
+            std::string answer = chooseAnswer(session, accuracy, rng);
+            output.clear();
+            session.handleInput(answer, output);
+            stats.questions++;
+        }
+
+        Clock::time_point start = Clock::now();
+        {
+            std::lock_guard<std::mutex> guard(leaderboardLock);
+            leaderboard.submit(session.getPlayerName(), session.getScore());
+        }
+        stats.leaderboardNs +=
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        stats.games++;
+        stats.totalScore += session.getScore();
+    }
+}
+
+void printPhase(const std::string& phase, long long ns, long long count, const std::string& unit) {
+    std::cout << "  " << std::left << std::setw(22) << phase << std::right << std::setw(10)
+              << std::fixed << std::setprecision(1)
+              << static_cast<double>(ns) / count << " ns/" << unit << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int games = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int threads = argc > 2 ? std::atoi(argv[2]) : 1;
+    unsigned seed = argc > 3 ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 42;
+    double accuracy = argc > 4 ? std::atof(argv[4]) / 100.0 : 0.6;
+    int players = argc > 5 ? std::atoi(argv[5]) : 1000;
+    if (games < 1 || threads < 1 || players < 1) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [games] [threads] [seed] [accuracy_percent] [players]" << std::endl;
+        return 1;
+    }
+
+    CommandCatalog catalog;
+    if (!catalog.loadCsv("commands.csv")) {
+        std::cerr << "commands.csv not found." << std::endl;
+        return 1;
+    }
+    if (catalog.getSize() < QuizSession::QUESTIONS_PER_GAME) {
+        std::cerr << "Need at least " << QuizSession::QUESTIONS_PER_GAME
+                  << " commands to play." << std::endl;
+        return 1;
+    }
+
+    Leaderboard leaderboard;
+    std::mutex leaderboardLock;
+    std::vector<BotStats> stats(threads);
+    std::vector<std::thread> workers;
+
+    Clock::time_point start = Clock::now();
+    for (int t = 0; t < threads; t++) {
+        int share = games / threads + (t < games % threads ? 1 : 0);
+        workers.push_back(std::thread(runBots, std::cref(catalog), std::ref(leaderboard),
+                                      std::ref(leaderboardLock), share, seed + t, accuracy,
+                                      players, std::ref(stats[t])));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    BotStats total;
+    for (const BotStats& s : stats) {
+        total.games += s.games;
+        total.questions += s.questions;
+        total.totalScore += s.totalScore;
+        total.leaderboardNs += s.leaderboardNs;
+        total.timings.generationNs += s.timings.generationNs;
+        total.timings.scoringNs += s.timings.scoringNs;
+    }
+
+    std::cout << "Played " << total.games << " games (" << total.questions << " questions) on "
+              << threads << " thread(s) against " << catalog.getSize() << " commands, seed "
+              << seed << std::endl;
+    std::cout << std::fixed << std::setprecision(0)
+              << "  games/sec             " << std::setw(10) << total.games / seconds << std::endl;
+    printPhase("question generation", total.timings.generationNs, total.questions, "question");
+    printPhase("scoring", total.timings.scoringNs, total.questions, "question");
+    printPhase("leaderboard update", total.leaderboardNs, total.games, "game");
+    std::cout << "  average score         " << std::setw(10) << std::setprecision(1)
+              << static_cast<double>(total.totalScore) / total.games << std::endl;
+
+    if (!leaderboard.isEmpty()) {
+        Player best = leaderboard.atRank(1);
+        std::cout << "  leader                " << best.name << " (" << best.score << " points, "
+                  << leaderboard.getSize() << " players)" << std::endl;
+    }
+    return 0;
+}
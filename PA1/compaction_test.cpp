@@ -0,0 +1,108 @@
+// Journal compaction test: a compaction that fails must not lose the
+// records it was folding in when the next compaction starts. Runs the game
+// in a scratch directory and makes compactions fail by putting a directory
+// where the temporary commands file would go.
+
+#include "Game.h"
+#include "Journal.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char* const JOURNAL_FILE = "game.journal";
+const char* const COMPACTING_JOURNAL_FILE = "game.journal.compacting";
+const char* const BLOCKER = "commands.csv.tmp";
+
+bool fileExists(const char* path) {
+    return access(path, F_OK) == 0;
+}
+
+// Records scores for players first..last-1 with long names, so a few
+// thousand of them fill the journal past the compaction threshold.
+void recordPlayers(Game& game, int first, int last) {
+    std::string padding(200, 'x');
+    for (int i = first; i < last; i++) {
+        game.recordScore(Player("player" + std::to_string(i) + padding, i + 1));
+    }
+}
+
+// Names of the players in both journals, as startup would replay them.
+std::set<std::string> journaledPlayers() {
+    std::set<std::string> names;
+    auto collect = [&names](const Journal::Record& record) {
+        if (record.type == Journal::SCORE) {
+            names.insert(record.name);
+        }
+    };
+    Journal::replay(COMPACTING_JOURNAL_FILE, collect);
+    Journal::replay(JOURNAL_FILE, collect);
+    return names;
+}
+
+std::set<std::string> savedPlayers() {
+    std::set<std::string> names;
+    std::ifstream file("leaderboard.csv");
+    std::string line;
+    while (std::getline(file, line)) {
+        names.insert(line.substr(0, line.find(',')));
+    }
+    return names;
+}
+
+}
+
+int main() {
+    char directory[] = "/tmp/compaction_testXXXXXX";
+    if (!mkdtemp(directory) || chdir(directory) != 0) {
+        std::cout << "ERROR: Could not create a scratch directory" << std::endl;
+        return 1;
+    }
+    std::ofstream("commands.csv") << "ls,\"List directory contents\",1\n";
+    mkdir(BLOCKER, 0755);
+
+    // About 4 MB of records: several compactions start, and all fail.
+    // Then, with writing working again, the next compaction folds in
+    // everything.
+    const int FAILING = 16000;
+    const int TOTAL = 24000;
+    {
+        Game game;
+        recordPlayers(game, 0, FAILING);
+        if (!fileExists(COMPACTING_JOURNAL_FILE)) {
+            std::cout << "ERROR: No compaction was attempted" << std::endl;
+            return 1;
+        }
+        int kept = static_cast<int>(journaledPlayers().size());
+        if (kept != FAILING) {
+            std::cout << "ERROR: Failed compactions lost journaled records (" << kept << " of "
+                      << FAILING << " left)" << std::endl;
+            return 1;
+        }
+        std::cout << "✓ Failed compactions kept all " << FAILING << " records" << std::endl;
+
+        rmdir(BLOCKER);
+        recordPlayers(game, FAILING, TOTAL);
+    }
+    if (fileExists(COMPACTING_JOURNAL_FILE)) {
+        std::cout << "ERROR: The compaction after the failures did not finish" << std::endl;
+        return 1;
+    }
+    std::set<std::string> all = savedPlayers();
+    std::set<std::string> pending = journaledPlayers();
+    all.insert(pending.begin(), pending.end());
+    if (static_cast<int>(all.size()) != TOTAL) {
+        std::cout << "ERROR: Saved files and journal hold " << all.size() << " of " << TOTAL
+                  << " players" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Compacting again saved all " << TOTAL << " records" << std::endl;
+
+    std::system((std::string("rm -rf ") + directory).c_str());
+    return 0;
+}
@@ -0,0 +1,182 @@
+/*
+ * Quiz load generator - plays many games against quiz_server at once and
+ * reports sessions per second and response latency percentiles.
+ * Usage: ./quiz_loadgen [socket_path] [clients] [games_per_client]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct ClientStats {
+    long long games;
+    long long failures;
+    std::vector<double> latenciesUs;
+
+    ClientStats() : games(0), failures(0) {}
+};
+
+int connectTo(const std::string& socketPath) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool sendLine(int fd, const std::string& line) {
+    std::string data = line + "\n";
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+// Reads until the server prints a prompt (text ending in ": ") or closes
+// the connection. Returns false on a read error.
+bool readReply(int fd, std::string& reply, bool& closed) {
+    reply.clear();
+    closed = false;
+    char buffer[4096];
+    while (reply.size() < 2 || reply.compare(reply.size() - 2, 2, ": ") != 0) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n == 0) {
+            closed = true;
+            return true;
+        }
+        if (n < 0) {
+            return false;
+        }
+        reply.append(buffer, n);
+    }
+    return true;
+}
+
+double elapsedUs(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+// Plays one full game with random answers, timing every server reply.
+bool playGame(const std::string& socketPath, const std::string& name,
+              std::mt19937& rng, ClientStats& stats) {
+    Clock::time_point start = Clock::now();
+    int fd = connectTo(socketPath);
+    if (fd < 0) {
+        return false;
+    }
+
+    std::string reply;
+    bool closed = false;
+    bool ok = readReply(fd, reply, closed) && !closed;
+    stats.latenciesUs.push_back(elapsedUs(start));
+
+    std::string line = name;
+    std::uniform_int_distribution<int> answer(1, 3);
+    while (ok && !closed) {
+        if (!sendLine(fd, line)) {
+            ok = false;
+            break;
+        }
+        start = Clock::now();
+        ok = readReply(fd, reply, closed);
+        stats.latenciesUs.push_back(elapsedUs(start));
+        line = std::to_string(answer(rng));
+    }
+
+    close(fd);
+    return ok && reply.find("=== GAME OVER ===") != std::string::npos;
+}
+
+void runClient(const std::string& socketPath, int clientId, int games, ClientStats& stats) {
+    std::mt19937 rng(clientId);
+    for (int i = 0; i < games; i++) {
+        std::string name = "bot" + std::to_string(clientId) + "-" + std::to_string(i);
+        if (playGame(socketPath, name, rng, stats)) {
+            stats.games++;
+        } else {
+            stats.failures++;
+        }
+    }
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[index];
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string socketPath = argc > 1 ? argv[1] : "quiz.sock";
+    int clients = argc > 2 ? std::atoi(argv[2]) : 100;
+    int gamesPerClient = argc > 3 ? std::atoi(argv[3]) : 10;
+    if (clients < 1 || gamesPerClient < 1) {
+        std::cerr << "Usage: " << argv[0] << " [socket_path] [clients] [games_per_client]" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Running " << clients << " concurrent clients x " << gamesPerClient
+              << " games against " << socketPath << std::endl;
+
+    std::vector<ClientStats> stats(clients);
+    std::vector<std::thread> threads;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < clients; i++) {
+        threads.push_back(std::thread(runClient, socketPath, i, gamesPerClient, std::ref(stats[i])));
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    double seconds = elapsedUs(start) / 1e6;
+
+    long long games = 0;
+    long long failures = 0;
+    std::vector<double> latencies;
+    for (const ClientStats& s : stats) {
+        games += s.games;
+        failures += s.failures;
+        latencies.insert(latencies.end(), s.latenciesUs.begin(), s.latenciesUs.end());
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Games completed: " << games << " (" << failures << " failed)" << std::endl;
+    std::cout << "Elapsed:         " << seconds << " s" << std::endl;
+    std::cout << "Sessions/sec:    " << games / seconds << std::endl;
+    std::cout << "Responses:       " << latencies.size() << std::endl;
+    std::cout << "Latency p50:     " << percentile(latencies, 0.50) << " us" << std::endl;
+    std::cout << "Latency p99:     " << percentile(latencies, 0.99) << " us" << std::endl;
+    std::cout << "Latency max:     " << (latencies.empty() ? 0.0 : latencies.back()) << " us" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+/*
+ * Quiz server - hosts many Linux Commands Matching Game sessions at once
+ * over a local Unix socket. Stop it with Ctrl-C to save the leaderboard.
+ * Usage: ./quiz_server [socket_path]
+*/
+
+#include "Game.h"
+#include "QuizServer.h"
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace {
+
+void handleSignal(int) {
+    QuizServer::stop();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string socketPath = argc > 1 ? argv[1] : "quiz.sock";
+
+    try {
+        Game game;
+        const CommandCatalog& catalog = game.getCatalog();
+        if (catalog.getSize() < QuizSession::QUESTIONS_PER_GAME) {
+            std::cerr << "Error: need at least " << QuizSession::QUESTIONS_PER_GAME
+                      << " commands to serve games." << std::endl;
+            return 1;
+        }
+
+        // No SA_RESTART, so a signal interrupts epoll_wait and run() returns.
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        action.sa_handler = handleSignal;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGINT, &action, nullptr);
+        sigaction(SIGTERM, &action, nullptr);
+
+        QuizServer server(catalog, [&game](Player player) {
+            game.recordScore(std::move(player));
+        });
+        if (!server.run(socketPath)) {
+            return 1;
+        }
+        game.saveAndExit();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,32 +1,72 @@
 #ifndef AVL_MAP_H
 #define AVL_MAP_H
 
+#include "frozen_map.h"
+#include "slab_allocator.h"
 #include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <new>
 #include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 // Template-based implementation of an AVL Tree Map
 // Stores key-value pairs in a balanced binary search tree
 // Keys are ordered, and lookup/insertion/deletion all work in O(log n)
-template<typename Key, typename Value>
+// Nodes come from Allocator (see slab_allocator.h), which defaults to
+// contiguous slabs with a free list.
+template<typename Key, typename Value, template<typename> class Allocator = slab_allocator>
 class avl_map {
+public:
+    // Element type, as in std::map: the key can be read but not changed
+    typedef Key key_type;
+    typedef Value mapped_type;
+    typedef std::pair<const Key, Value> value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
 private:
-    // Structure representing a node in the AVL tree
+    // Structure representing a node in the AVL tree. The links come
+    // first so that they share a cache line with the key even when the
+    // value is large.
     struct AVLNode {
-        Key key;            // Key (used for ordering)
-        Value value;        // Value associated with the key
         AVLNode* left;      // Pointer to left child
         AVLNode* right;     // Pointer to right child
+        AVLNode* parent;    // Pointer to parent (nullptr at the root)
         int height;         // Height of this node (for balancing)
+        value_type data;    // Key (used for ordering) and its value
 
-        // Constructor for creating a new node
-        AVLNode(const Key& k, const Value& v)
-            : key(k), value(v), left(nullptr), right(nullptr), height(1) {}
+        // Constructor for creating a new node; args build the pair
+        template<typename... Args>
+        AVLNode(AVLNode* p, Args&&... args)
+            : left(nullptr), right(nullptr), parent(p), height(1),
+              data(std::forward<Args>(args)...) {}
     };
 
+    Allocator<AVLNode> pool; // Storage for the nodes
     AVLNode* root;          // Root node of the AVL tree
     int size_count;         // Keeps track of number of nodes in the tree
 
+    // Builds a node in storage from the pool, and destroys one back into it
+    template<typename... Args>
+    AVLNode* createNode(AVLNode* parent, Args&&... args) {
+        void* storage = pool.allocate();
+        try {
+            return new (storage) AVLNode(parent, std::forward<Args>(args)...);
+        } catch (...) {
+            pool.deallocate(storage);
+            throw;
+        }
+    }
+
+    void destroyNode(AVLNode* node) {
+        node->~AVLNode();
+        pool.deallocate(node);
+    }
+
     // Helper function: returns height of a node (0 if nullptr)
     int height(AVLNode* node) const {
         return node ? node->height : 0;
@@ -54,6 +94,11 @@ private:
         x->right = y;
         y->left = T2;
 
+        // Fix parent pointers; the caller relinks x from above
+        if (T2) T2->parent = y;
+        x->parent = y->parent;
+        y->parent = x;
+
         // Update heights after rotation
         updateHeight(y);
         updateHeight(x);
@@ -69,219 +114,669 @@ private:
         y->left = x;
         x->right = T2;
 
+        // Fix parent pointers; the caller relinks y from above
+        if (T2) T2->parent = x;
+        y->parent = x->parent;
+        x->parent = y;
+
         // Update heights after rotation
         updateHeight(x);
         updateHeight(y);
         return y;  // New root after rotation
     }
 
-    // Recursive helper for inserting a new key-value pair
-    AVLNode* insertHelper(AVLNode* node, const Key& key, const Value& value) {
-        // Base case: reached null, insert here
-        if (!node) {
-            size_count++;
-            return new AVLNode(key, value);
-        }
-
-        // BST insert logic (left or right based on key comparison)
-        if (key < node->key) {
-            node->left = insertHelper(node->left, key, value);
-        } else if (key > node->key) {
-            node->right = insertHelper(node->right, key, value);
-        } else {
-            // If key already exists, update its value
-            node->value = value;
-            return node;
-        }
-
-        // Update height after insertion
-        updateHeight(node);
+    // Deepest path insert and erase can walk. An AVL tree of height h holds
+    // at least F(h+2)-1 nodes (Fibonacci), so 64 levels is far beyond any
+    // tree whose size fits in an int.
+    static const int MAX_HEIGHT = 64;
 
-        // Get balance factor to check if rebalancing is needed
+    // Restores the AVL property at a node whose children are balanced and
+    // whose height is up to date. Returns the new root of the subtree.
+    AVLNode* rebalance(AVLNode* node) {
         int balance = getBalance(node);
 
-        // Case 1: Left Left (heavy on left-left side)
-        if (balance > 1 && key < node->left->key)
+        // Left-heavy: Left-Left needs one right rotation, Left-Right first
+        // rotates the left child
+        if (balance > 1) {
+            if (getBalance(node->left) < 0)
+                node->left = rotateLeft(node->left);
             return rotateRight(node);
+        }
 
-        // Case 2: Right Right (heavy on right-right side)
-        if (balance < -1 && key > node->right->key)
+        // Right-heavy: mirror image of the above
+        if (balance < -1) {
+            if (getBalance(node->right) > 0)
+                node->right = rotateRight(node->right);
             return rotateLeft(node);
+        }
 
-        // Case 3: Left Right
-        if (balance > 1 && key > node->left->key) {
-            node->left = rotateLeft(node->left);
-            return rotateRight(node);
+        return node;
+    }
+
+    // Walks back up a path of links (path[0] is &root), fixing heights and
+    // rotating where needed. Stops as soon as a subtree keeps its old
+    // height, since nothing above it can have changed.
+    void rebalancePath(AVLNode** path[], int depth) {
+        for (int i = depth - 1; i >= 0; i--) {
+            AVLNode* node = *path[i];
+            int oldHeight = node->height;
+            updateHeight(node);
+            *path[i] = rebalance(node);
+            if ((*path[i])->height == oldHeight)
+                break;
         }
+    }
 
-        // Case 4: Right Left
-        if (balance < -1 && key < node->right->key) {
-            node->right = rotateRight(node->right);
-            return rotateLeft(node);
+    // Where a key sits in the tree, or would be linked in: the links
+    // followed from the root, the empty link, and the node above it.
+    struct InsertPosition {
+        AVLNode** path[MAX_HEIGHT];
+        int depth;
+        AVLNode** link;
+        AVLNode* parent;
+    };
+
+    // Walks down to key. Returns its node if present; otherwise fills pos
+    // for attachNode(). Like findNode(), one `<` per level, and one more
+    // at the bottom to tell an equal key from a smaller one.
+    AVLNode* findInsertPosition(const Key& key, InsertPosition& pos) {
+        pos.depth = 0;
+        pos.link = &root;
+        pos.parent = nullptr;
+
+        AVLNode* candidate = nullptr;
+        while (*pos.link) {
+            pos.path[pos.depth++] = pos.link;
+            AVLNode* node = *pos.link;
+            pos.parent = node;
+            if (key < node->data.first) {
+                pos.link = &node->left;
+            } else {
+                candidate = node;
+                pos.link = &node->right;
+            }
         }
+        if (candidate && !(candidate->data.first < key))
+            return candidate;
+        return nullptr;
+    }
 
-        // Return node pointer (unchanged if already balanced)
-        return node;
+    // Links a new node at pos, then rebalances back up only as far as
+    // heights change.
+    void attachNode(AVLNode* node, InsertPosition& pos) {
+        node->parent = pos.parent;
+        *pos.link = node;
+        size_count++;
+        rebalancePath(pos.path, pos.depth);
     }
 
-    // Finds the smallest node in a subtree (used during deletion)
-    AVLNode* minValueNode(AVLNode* node) const {
-        AVLNode* current = node;
-        while (current->left)
-            current = current->left;
-        return current;
+    // Inserts or overwrites; V is const Value& or Value&&
+    template<typename V>
+    std::pair<AVLNode*, bool> assign(const Key& key, V&& value) {
+        InsertPosition pos;
+        if (AVLNode* node = findInsertPosition(key, pos)) {
+            node->data.second = std::forward<V>(value);
+            return std::make_pair(node, false);
+        }
+        AVLNode* node = createNode(pos.parent, key, std::forward<V>(value));
+        attachNode(node, pos);
+        return std::make_pair(node, true);
     }
 
-    // Recursive helper for deleting a node by key
-    AVLNode* eraseHelper(AVLNode* node, const Key& key) {
-        if (!node) return node;
+    // Copies the subtree at source into *link, giving the copy the same
+    // shape and heights. Each node is linked in before its children are
+    // copied, so a copy that throws leaves a tree clear() can free.
+    void copyTree(AVLNode** link, const AVLNode* source, AVLNode* parent) {
+        while (source) {
+            AVLNode* node = createNode(parent, source->data);
+            node->height = source->height;
+            *link = node;
+            copyTree(&node->left, source->left, node);
+            link = &node->right;      // Loop instead of recursing on the right
+            source = source->right;
+            parent = node;
+        }
+    }
 
-        // Standard BST deletion logic
-        if (key < node->key) {
-            node->left = eraseHelper(node->left, key);
-        } else if (key > node->key) {
-            node->right = eraseHelper(node->right, key);
-        } else {
-            // Node to delete found
-            if (!node->left || !node->right) {
-                // Case: one child or no child
-                AVLNode* temp = node->left ? node->left : node->right;
-
-                if (!temp) {
-                    // No child case
-                    temp = node;
-                    node = nullptr;
-                } else {
-                    // One child case
-                    *node = *temp;  // Copy child data into current node
-                }
+    // Links nodes[lo..hi], which are in key order, into a perfectly
+    // balanced subtree and returns its root. The middle node becomes the
+    // root, so the two halves differ in size by at most one and the
+    // result is a valid AVL tree. O(n), and no rotations.
+    static AVLNode* linkBalanced(AVLNode** nodes, int lo, int hi, AVLNode* parent) {
+        if (lo > hi) return nullptr;
+        int mid = lo + (hi - lo) / 2;
+        AVLNode* node = nodes[mid];
+        node->parent = parent;
+        node->left = linkBalanced(nodes, lo, mid - 1, node);
+        node->right = linkBalanced(nodes, mid + 1, hi, node);
+        node->height = 1 + std::max(node->left ? node->left->height : 0,
+                                    node->right ? node->right->height : 0);
+        return node;
+    }
 
-                delete temp;
-                size_count--;
+    // Replaces the (empty) tree with the elements of [first, last), whose
+    // keys must be strictly increasing. Nodes are built in key order from
+    // one reserved block, so an in-order scan walks memory sequentially.
+    template<typename ForwardIt>
+    void buildSorted(ForwardIt first, ForwardIt last) {
+        std::vector<AVLNode*> nodes;
+        nodes.reserve(static_cast<std::size_t>(std::distance(first, last)));
+        pool.reserve(nodes.capacity());
+        try {
+            for (; first != last; ++first)
+                nodes.push_back(createNode(nullptr, *first));
+        } catch (...) {
+            for (AVLNode* node : nodes)
+                destroyNode(node);
+            throw;
+        }
+        root = linkBalanced(nodes.data(), 0, static_cast<int>(nodes.size()) - 1, nullptr);
+        size_count = static_cast<int>(nodes.size());
+    }
+
+    // Finds the node holding key, or nullptr. Each level does a single
+    // `key < node` test, whatever the key type. candidate is the last node
+    // not greater than key, so after reaching the bottom the key is
+    // present only if candidate is not less than it either: one more test.
+    AVLNode* findNode(const Key& key) const {
+        AVLNode* node = root;
+        AVLNode* candidate = nullptr;
+        while (node) {
+            if (key < node->data.first) {
+                node = node->left;
             } else {
-                // Case: node with two children
-                AVLNode* temp = minValueNode(node->right);
-                node->key = temp->key;
-                node->value = temp->value;
-                node->right = eraseHelper(node->right, temp->key);
+                candidate = node;
+                node = node->right;
             }
         }
+        if (candidate && !(candidate->data.first < key))
+            return candidate;
+        return nullptr;
+    }
 
-        // If the tree had only one node
-        if (!node) return node;
-
-        // Update height and balance factor
-        updateHeight(node);
-        int balance = getBalance(node);
+    // Leftmost and rightmost nodes of a subtree
+    static AVLNode* minNode(AVLNode* node) {
+        while (node->left) node = node->left;
+        return node;
+    }
 
-        // Balance the tree using rotations if needed
-        if (balance > 1 && getBalance(node->left) >= 0)
-            return rotateRight(node);
+    static AVLNode* maxNode(AVLNode* node) {
+        while (node->right) node = node->right;
+        return node;
+    }
 
-        if (balance > 1 && getBalance(node->left) < 0) {
-            node->left = rotateLeft(node->left);
-            return rotateRight(node);
+    // In-order neighbours. Either go down into a subtree, or climb until
+    // we arrive from the other side; each edge is crossed at most twice
+    // over a full traversal, so a step is O(1) amortized.
+    static AVLNode* successor(AVLNode* node) {
+        if (node->right) return minNode(node->right);
+        AVLNode* parent = node->parent;
+        while (parent && node == parent->right) {
+            node = parent;
+            parent = parent->parent;
         }
+        return parent;
+    }
 
-        if (balance < -1 && getBalance(node->right) <= 0)
-            return rotateLeft(node);
+    static AVLNode* predecessor(AVLNode* node) {
+        if (node->left) return maxNode(node->left);
+        AVLNode* parent = node->parent;
+        while (parent && node == parent->left) {
+            node = parent;
+            parent = parent->parent;
+        }
+        return parent;
+    }
 
-        if (balance < -1 && getBalance(node->right) > 0) {
-            node->right = rotateRight(node->right);
-            return rotateLeft(node);
+    // First node whose key is not less than key (lower_bound), or greater
+    // than key (upper_bound); nullptr if there is none. Every time the
+    // walk turns left, the node it leaves is the best candidate so far.
+    AVLNode* lowerBoundNode(const Key& key) const {
+        AVLNode* node = root;
+        AVLNode* best = nullptr;
+        while (node) {
+            if (node->data.first < key) {
+                node = node->right;
+            } else {
+                best = node;
+                node = node->left;
+            }
         }
+        return best;
+    }
 
-        return node;
+    AVLNode* upperBoundNode(const Key& key) const {
+        AVLNode* node = root;
+        AVLNode* best = nullptr;
+        while (node) {
+            if (key < node->data.first) {
+                best = node;
+                node = node->left;
+            } else {
+                node = node->right;
+            }
+        }
+        return best;
     }
 
-    // Recursive search for a given key
-    AVLNode* findHelper(AVLNode* node, const Key& key) const {
-        if (!node) return nullptr;
-        if (key < node->key)
-            return findHelper(node->left, key);
-        else if (key > node->key)
-            return findHelper(node->right, key);
-        else
-            return node;  // Found the key
+    // In-order visit of the keys in [lo, hi]. A subtree is skipped when
+    // all of its keys lie on one side of the range, so the visit touches
+    // O(log n + k) nodes for k results.
+    template<typename Reference, typename Function>
+    static void visitRange(AVLNode* node, const Key& lo, const Key& hi, Function& fn) {
+        while (node) {
+            bool aboveLo = lo < node->data.first;
+            bool belowHi = node->data.first < hi;
+            if (aboveLo)
+                visitRange<Reference>(node->left, lo, hi, fn);
+            if (!(node->data.first < lo) && !(hi < node->data.first))
+                fn(static_cast<Reference>(node->data));
+            if (!belowHi)
+                return;
+            node = node->right;   // Loop instead of recursing on the right
+        }
     }
 
-    // Frees all memory used by the tree
+    // Destroys every node of a subtree; the pool keeps the memory
     void destroyTree(AVLNode* node) {
         if (node) {
             destroyTree(node->left);
             destroyTree(node->right);
-            delete node;
+            destroyNode(node);
         }
     }
 
 public:
-    // Simple iterator that wraps a node pointer
-    class iterator {
+    // Bidirectional in-order iterator. Incrementing follows child and
+    // parent pointers, so no stack is needed. end() is a null node; the
+    // iterator also remembers its map so that --end() can find the last
+    // element. IsConst selects const_iterator.
+    template<bool IsConst>
+    class basic_iterator {
     private:
+        friend class avl_map;
+        friend class basic_iterator<true>;
+
+        typedef typename std::conditional<IsConst, const avl_map, avl_map>::type map_type;
+
         AVLNode* node;
+        map_type* owner;
 
-    public:
-        iterator(AVLNode* n) : node(n) {}
+        basic_iterator(AVLNode* n, map_type* m) : node(n), owner(m) {}
 
-        // Dereference operators to access value
-        Value& operator*() {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef typename avl_map::value_type value_type;
+        typedef typename avl_map::difference_type difference_type;
+        typedef typename std::conditional<IsConst, const value_type*, value_type*>::type pointer;
+        typedef typename std::conditional<IsConst, const value_type&, value_type&>::type reference;
+
+        basic_iterator() : node(nullptr), owner(nullptr) {}
+
+        // An iterator converts to a const_iterator, but not the other way
+        template<bool OtherConst,
+                 typename = typename std::enable_if<IsConst && !OtherConst>::type>
+        basic_iterator(const basic_iterator<OtherConst>& other)
+            : node(other.node), owner(other.owner) {}
+
+        // Dereference operators give the stored (key, value) pair
+        reference operator*() const {
             if (!node) throw std::out_of_range("Dereferencing end iterator");
-            return node->value;
+            return node->data;
         }
 
-        Value* operator->() {
+        pointer operator->() const {
             if (!node) throw std::out_of_range("Dereferencing end iterator");
-            return &(node->value);
+            return &node->data;
+        }
+
+        // Step to the next key; end() follows the largest one
+        basic_iterator& operator++() {
+            node = successor(node);
+            return *this;
+        }
+
+        basic_iterator operator++(int) {
+            basic_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        // Step to the previous key; --end() is the largest one
+        basic_iterator& operator--() {
+            node = node ? predecessor(node) : maxNode(owner->root);
+            return *this;
+        }
+
+        basic_iterator operator--(int) {
+            basic_iterator old = *this;
+            --*this;
+            return old;
         }
 
         // Equality and inequality checks for iterators
-        bool operator==(const iterator& other) const {
+        bool operator==(const basic_iterator& other) const {
             return node == other.node;
         }
 
-        bool operator!=(const iterator& other) const {
+        bool operator!=(const basic_iterator& other) const {
             return !(*this == other);
         }
 
-        // Helper to access key from iterator
-        Key getKey() const {
-            if (!node) throw std::out_of_range("Dereferencing end iterator");
-            return node->key;
+        // Shorthands for it->first and it->second
+        const Key& getKey() const {
+            return (**this).first;
+        }
+
+        typename std::conditional<IsConst, const Value&, Value&>::type getValue() const {
+            return (**this).second;
         }
     };
 
+    typedef basic_iterator<false> iterator;
+    typedef basic_iterator<true> const_iterator;
+
     // Constructor initializes empty AVL map
-    avl_map() : root(nullptr), size_count(0) {}
+    avl_map() : pool(), root(nullptr), size_count(0) {}
 
     // Destructor cleans up all dynamically allocated nodes
-    ~avl_map() { destroyTree(root); }
+    ~avl_map() { clear(); }
+
+    // Removes every element. The node destructors run one by one, then
+    // the pool returns its blocks all at once.
+    void clear() {
+        destroyTree(root);
+        pool.release();
+        root = nullptr;
+        size_count = 0;
+    }
+
+    // Copies every element; the copy has the same shape, so no
+    // rebalancing is done
+    avl_map(const avl_map& other) : pool(), root(nullptr), size_count(0) {
+        try {
+            copyTree(&root, other.root, nullptr);
+        } catch (...) {
+            clear();
+            throw;
+        }
+        size_count = other.size_count;
+    }
+
+    // Takes over other's nodes and their storage; other is left empty
+    avl_map(avl_map&& other) noexcept
+        : pool(std::move(other.pool)), root(other.root), size_count(other.size_count) {
+        other.root = nullptr;
+        other.size_count = 0;
+    }
+
+    avl_map& operator=(const avl_map& other) {
+        if (this != &other) {
+            avl_map copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    avl_map& operator=(avl_map&& other) noexcept {
+        if (this != &other) {
+            clear();
+            pool = std::move(other.pool);
+            root = other.root;
+            size_count = other.size_count;
+            other.root = nullptr;
+            other.size_count = 0;
+        }
+        return *this;
+    }
+
+    // Builds a map from [first, last) in O(n) when the elements, pairs
+    // of (key, value), are already in strictly increasing key order, as
+    // the ZIP code file is. The result is perfectly balanced. Otherwise
+    // the elements are copied, stably sorted by key and deduplicated
+    // (the last value for a key wins, as with repeated insert) first, at
+    // O(n log n). Pass move iterators to move the values in.
+    template<typename ForwardIt>
+    static avl_map build_from_sorted(ForwardIt first, ForwardIt last) {
+        avl_map result;
+
+        // Strictly increasing keys can be linked directly
+        bool sorted = true;
+        if (first != last) {
+            ForwardIt previous = first;
+            for (ForwardIt it = std::next(first); it != last; previous = it, ++it) {
+                if (!((*previous).first < (*it).first)) {
+                    sorted = false;
+                    break;
+                }
+            }
+        }
+        if (sorted) {
+            result.buildSorted(first, last);
+            return result;
+        }
+
+        // Fallback: sort a copy by key and keep the last value of each key
+        std::vector<std::pair<Key, Value> > items(first, last);
+        std::stable_sort(items.begin(), items.end(),
+                         [](const std::pair<Key, Value>& a, const std::pair<Key, Value>& b) {
+                             return a.first < b.first;
+                         });
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < items.size(); i++) {
+            if (i + 1 < items.size() && !(items[i].first < items[i + 1].first))
+                continue;   // A later element has the same key
+            if (kept != i)
+                items[kept] = std::move(items[i]);
+            kept++;
+        }
+        items.erase(items.begin() + kept, items.end());
+        result.buildSorted(std::make_move_iterator(items.begin()),
+                           std::make_move_iterator(items.end()));
+        return result;
+    }
+
+    void swap(avl_map& other) {
+        std::swap(pool, other.pool);
+        std::swap(root, other.root);
+        std::swap(size_count, other.size_count);
+    }
 
-    // Public insert function
-    void insert(const Key& key, const Value& value) {
-        root = insertHelper(root, key, value);
+    // Inserts a key-value pair, or updates the value if the key exists.
+    // Returns the element and whether it is new. The rvalue overload moves
+    // the value into the node (or over the old value) instead of copying.
+    std::pair<iterator, bool> insert(const Key& key, const Value& value) {
+        std::pair<AVLNode*, bool> result = assign(key, value);
+        return std::make_pair(iterator(result.first, this), result.second);
     }
 
-    // Public erase function
+    std::pair<iterator, bool> insert(const Key& key, Value&& value) {
+        std::pair<AVLNode*, bool> result = assign(key, std::move(value));
+        return std::make_pair(iterator(result.first, this), result.second);
+    }
+
+    // Builds the (key, value) pair in place from args, as std::map does.
+    // If the key is already present the new pair is destroyed and the
+    // existing element is left unchanged.
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        AVLNode* node = createNode(nullptr, std::forward<Args>(args)...);
+        InsertPosition pos;
+        AVLNode* existing;
+        try {
+            existing = findInsertPosition(node->data.first, pos);
+        } catch (...) {
+            destroyNode(node);
+            throw;
+        }
+        if (existing) {
+            destroyNode(node);
+            return std::make_pair(iterator(existing, this), false);
+        }
+        attachNode(node, pos);
+        return std::make_pair(iterator(node, this), true);
+    }
+
+    // Builds Value(args...) in place only if key is absent; otherwise
+    // does nothing (args are not moved from)
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        InsertPosition pos;
+        if (AVLNode* existing = findInsertPosition(key, pos))
+            return std::make_pair(iterator(existing, this), false);
+        AVLNode* node = createNode(pos.parent, std::piecewise_construct,
+                                   std::forward_as_tuple(key),
+                                   std::forward_as_tuple(std::forward<Args>(args)...));
+        attachNode(node, pos);
+        return std::make_pair(iterator(node, this), true);
+    }
+
+    // Removes key if present. A node with two children is replaced by its
+    // in-order successor, which is unlinked from below and relinked in the
+    // removed node's place.
     void erase(const Key& key) {
-        root = eraseHelper(root, key);
+        AVLNode** path[MAX_HEIGHT];
+        int depth = 0;
+        AVLNode** found = &root;
+
+        // Walk down to the node, recording every link including its own
+        while (*found) {
+            path[depth++] = found;
+            AVLNode* node = *found;
+            if (key < node->data.first)
+                found = &node->left;
+            else if (node->data.first < key)
+                found = &node->right;
+            else
+                break;
+        }
+        if (!*found)
+            return;   // Key not present
+
+        AVLNode* target = *found;
+
+        if (!target->left || !target->right) {
+            // Case: one child or no child - the child takes its place
+            AVLNode* child = target->left ? target->left : target->right;
+            if (child) child->parent = target->parent;
+            *found = child;
+            depth--;
+        } else {
+            // Case: two children - find the successor, recording the path
+            int targetIndex = depth - 1;
+            AVLNode** successorLink = &target->right;
+            path[depth++] = successorLink;
+            while ((*successorLink)->left) {
+                successorLink = &(*successorLink)->left;
+                path[depth++] = successorLink;
+            }
+
+            // Unlink the successor (it has no left child), then move it
+            // into the removed node's place
+            AVLNode* next = *successorLink;
+            *successorLink = next->right;
+            if (next->right) next->right->parent = next->parent;
+            depth--;
+            next->left = target->left;
+            next->right = target->right;
+            next->parent = target->parent;
+            next->height = target->height;
+            next->left->parent = next;
+            if (next->right) next->right->parent = next;
+            *found = next;
+
+            // The path went through target->right, which is now next->right
+            if (depth > targetIndex + 1)
+                path[targetIndex + 1] = &next->right;
+        }
+
+        destroyNode(target);
+        size_count--;
+        rebalancePath(path, depth);
     }
 
     // Returns an iterator pointing to the node if found
     iterator find(const Key& key) {
-        AVLNode* node = findHelper(root, key);
-        return iterator(node);
+        return iterator(findNode(key), this);
+    }
+
+    const_iterator find(const Key& key) const {
+        return const_iterator(findNode(key), this);
     }
 
+    // Returns iterator to the first key that is not less than key
+    iterator lower_bound(const Key& key) {
+        return iterator(lowerBoundNode(key), this);
+    }
+
+    const_iterator lower_bound(const Key& key) const {
+        return const_iterator(lowerBoundNode(key), this);
+    }
+
+    // Returns iterator to the first key that is greater than key
+    iterator upper_bound(const Key& key) {
+        return iterator(upperBoundNode(key), this);
+    }
+
+    const_iterator upper_bound(const Key& key) const {
+        return const_iterator(upperBoundNode(key), this);
+    }
+
+    // Returns the range of elements with this key (empty or one element)
+    std::pair<iterator, iterator> equal_range(const Key& key) {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const Key& key) const {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    // Calls fn(pair) for every element with lo <= key <= hi, in key order.
+    // Both ends are included, so for_each_in_range(98000, 99499, fn) sees
+    // ZIP 99499. Does nothing if hi < lo.
+    template<typename Function>
+    void for_each_in_range(const Key& lo, const Key& hi, Function fn) {
+        visitRange<value_type&>(root, lo, hi, fn);
+    }
+
+    template<typename Function>
+    void for_each_in_range(const Key& lo, const Key& hi, Function fn) const {
+        visitRange<const value_type&>(root, lo, hi, fn);
+    }
+
+    // Returns iterator to the smallest key (end() if empty)
+    iterator begin() {
+        return iterator(root ? minNode(root) : nullptr, this);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(root ? minNode(root) : nullptr, this);
+    }
+
+    const_iterator cbegin() const { return begin(); }
+
     // Returns iterator representing "end" (null)
     iterator end() {
-        return iterator(nullptr);
+        return iterator(nullptr, this);
+    }
+
+    const_iterator end() const {
+        return const_iterator(nullptr, this);
     }
 
+    const_iterator cend() const { return end(); }
+
     // Returns number of elements in the map
     int size() const {
         return size_count;
     }
 
+    // Copies the current contents into a read-only frozen_map, whose
+    // lookups are faster once the map stops changing. O(n).
+    frozen_map<Key, Value> freeze() const {
+        return frozen_map<Key, Value>(begin(), end());
+    }
+
     // Checks if the map is empty
     bool empty() const {
         return size_count == 0;
@@ -0,0 +1,848 @@
+#ifndef BTREE_MAP_H
+#define BTREE_MAP_H
+
+#include "slab_allocator.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Ordered map stored as a B+ tree, with the same interface as avl_map.
+// A node holds many keys, so a lookup follows about log_32(n) pointers
+// instead of log_2(n), and each node's keys are searched in place
+// within a couple of cache lines.
+//
+// All elements live in the leaves, which are chained in key order for
+// iteration. Inner nodes only hold copies of keys that separate their
+// children. Unlike avl_map, insert and erase move elements between
+// slots, so they invalidate iterators and references.
+template<typename Key, typename Value, template<typename> class Allocator = slab_allocator>
+class btree_map {
+public:
+    // Element type, as in std::map: the key can be read but not changed
+    typedef Key key_type;
+    typedef Value mapped_type;
+    typedef std::pair<const Key, Value> value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+private:
+    // Node sizes: the keys of a node fill KEY_BYTES (two cache lines), so
+    // for int keys a node holds 32 of them. Large keys still get at
+    // least MIN_SLOTS per node to keep the tree shallow.
+    static const int KEY_BYTES = 128;
+    static const int MIN_SLOTS = 8;
+    static const int SLOTS = static_cast<int>(KEY_BYTES / sizeof(Key)) > MIN_SLOTS
+                             ? static_cast<int>(KEY_BYTES / sizeof(Key)) : MIN_SLOTS;
+    // Erase keeps every node that is neither the root nor on the right
+    // edge of the tree at least this full (see splitLeaf for the right edge)
+    static const int MIN_COUNT = SLOTS / 2;
+    // Deepest tree the insert and erase paths can record
+    static const int MAX_DEPTH = 32;
+
+    // Uninitialized storage for N objects; slots are constructed and
+    // destroyed one at a time as elements come and go. Every array has one
+    // spare slot, so a full node can take one more element and then split.
+    template<typename T, int N>
+    struct SlotArray {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[N];
+
+        T& operator[](int i) { return *reinterpret_cast<T*>(&slots[i]); }
+        const T& operator[](int i) const { return *reinterpret_cast<const T*>(&slots[i]); }
+        T* data() { return reinterpret_cast<T*>(slots); }
+        const T* data() const { return reinterpret_cast<const T*>(slots); }
+    };
+
+    // Leaf: the keys on their own for searching, and the elements. An
+    // element's key is stored twice so that searches touch only the
+    // key array and iterators can still hand out value_type references.
+    struct LeafNode {
+        int count;
+        LeafNode* prev;
+        LeafNode* next;
+        SlotArray<Key, SLOTS + 1> keys;
+        SlotArray<value_type, SLOTS + 1> items;
+
+        LeafNode() : count(0), prev(nullptr), next(nullptr) {}
+    };
+
+    // Inner node: children[i] holds the keys k with
+    // keys[i-1] <= k < keys[i].
+    struct InnerNode {
+        int count;                      // Number of keys; children = count + 1
+        SlotArray<Key, SLOTS + 1> keys;
+        void* children[SLOTS + 2];      // InnerNode* or LeafNode*, by level
+
+        InnerNode() : count(0) {}
+    };
+
+    // One step of a descent: the inner node and which child was taken
+    struct PathStep {
+        InnerNode* node;
+        int index;
+    };
+
+    Allocator<LeafNode> leafPool;
+    Allocator<InnerNode> innerPool;
+    void* root;             // LeafNode* when levels == 0, else InnerNode*
+    int levels;             // Number of inner levels above the leaves
+    LeafNode* firstLeaf;    // Start and end of the leaf chain
+    LeafNode* lastLeaf;
+    int size_count;         // Keeps track of number of elements
+
+    // Moves the object in one slot into another, empty slot
+    template<typename T>
+    static void relocate(T& from, T* to) {
+        new (to) T(std::move(from));
+        from.~T();
+    }
+
+    // Elements of a value_type slot cannot be moved into (the key is
+    // const), so they are rebuilt from a moved key and value
+    static void relocate(value_type& from, value_type* to) {
+        new (to) value_type(std::piecewise_construct,
+                            std::forward_as_tuple(std::move(const_cast<Key&>(from.first))),
+                            std::forward_as_tuple(std::move(from.second)));
+        from.~value_type();
+    }
+
+    // Index of the first key in keys[0, count) that is not less than key
+    // (lower) or greater than key (upper). Built-in keys are compared
+    // with every slot and the results summed: no branches to mispredict,
+    // and the loop vectorizes. Other keys use binary search.
+    static int lowerIndex(const Key* keys, int count, const Key& key) {
+        return lowerIndex(keys, count, key, std::is_arithmetic<Key>());
+    }
+
+    static int lowerIndex(const Key* keys, int count, const Key& key, std::true_type) {
+        int index = 0;
+        for (int i = 0; i < count; i++)
+            index += keys[i] < key;
+        return index;
+    }
+
+    static int lowerIndex(const Key* keys, int count, const Key& key, std::false_type) {
+        return static_cast<int>(std::lower_bound(keys, keys + count, key) - keys);
+    }
+
+    static int upperIndex(const Key* keys, int count, const Key& key) {
+        return upperIndex(keys, count, key, std::is_arithmetic<Key>());
+    }
+
+    static int upperIndex(const Key* keys, int count, const Key& key, std::true_type) {
+        int index = 0;
+        for (int i = 0; i < count; i++)
+            index += !(key < keys[i]);
+        return index;
+    }
+
+    static int upperIndex(const Key* keys, int count, const Key& key, std::false_type) {
+        return static_cast<int>(std::upper_bound(keys, keys + count, key) - keys);
+    }
+
+    // Walks from the root to the leaf that would hold key, recording the
+    // inner nodes passed through when path is given
+    LeafNode* findLeaf(const Key& key, PathStep* path) const {
+        void* node = root;
+        for (int level = 0; level < levels; level++) {
+            InnerNode* inner = static_cast<InnerNode*>(node);
+            int index = upperIndex(inner->keys.data(), inner->count, key);
+            if (path) {
+                path[level].node = inner;
+                path[level].index = index;
+            }
+            node = inner->children[index];
+        }
+        return static_cast<LeafNode*>(node);
+    }
+
+    // Position of key in the tree, or (nullptr, 0) if it is absent
+    std::pair<LeafNode*, int> findPosition(const Key& key) const {
+        if (!root) return std::make_pair(static_cast<LeafNode*>(nullptr), 0);
+        LeafNode* leaf = findLeaf(key, nullptr);
+        int index = lowerIndex(leaf->keys.data(), leaf->count, key);
+        if (index < leaf->count && !(key < leaf->keys[index]))
+            return std::make_pair(leaf, index);
+        return std::make_pair(static_cast<LeafNode*>(nullptr), 0);
+    }
+
+    // First element not less than key (lower) or greater than key
+    // (upper). A leaf's bound can be its end, which is the next leaf's
+    // first element.
+    std::pair<LeafNode*, int> boundPosition(const Key& key, bool upper) const {
+        if (!root) return std::make_pair(static_cast<LeafNode*>(nullptr), 0);
+        LeafNode* leaf = findLeaf(key, nullptr);
+        int index = upper ? upperIndex(leaf->keys.data(), leaf->count, key)
+                          : lowerIndex(leaf->keys.data(), leaf->count, key);
+        if (index == leaf->count)
+            return std::make_pair(leaf->next, 0);
+        return std::make_pair(leaf, index);
+    }
+
+    LeafNode* createLeaf() {
+        return new (leafPool.allocate()) LeafNode();
+    }
+
+    InnerNode* createInner() {
+        return new (innerPool.allocate()) InnerNode();
+    }
+
+    // Destroys every element and key of a leaf, then the leaf itself
+    void destroyLeaf(LeafNode* leaf) {
+        for (int i = 0; i < leaf->count; i++) {
+            leaf->keys[i].~Key();
+            leaf->items[i].~value_type();
+        }
+        leaf->~LeafNode();
+        leafPool.deallocate(leaf);
+    }
+
+    void destroyInner(InnerNode* inner) {
+        for (int i = 0; i < inner->count; i++)
+            inner->keys[i].~Key();
+        inner->~InnerNode();
+        innerPool.deallocate(inner);
+    }
+
+    void destroySubtree(void* node, int level) {
+        if (level == 0) {
+            destroyLeaf(static_cast<LeafNode*>(node));
+            return;
+        }
+        InnerNode* inner = static_cast<InnerNode*>(node);
+        for (int i = 0; i <= inner->count; i++)
+            destroySubtree(inner->children[i], level - 1);
+        destroyInner(inner);
+    }
+
+    // Slot shifting inside a node. Opening a gap at index moves
+    // [index, count) up by one; closing it moves them back down.
+    template<typename T, int N>
+    static void openGap(SlotArray<T, N>& slots, int count, int index) {
+        for (int i = count; i > index; i--)
+            relocate(slots[i - 1], &slots[i]);
+    }
+
+    template<typename T, int N>
+    static void closeGap(SlotArray<T, N>& slots, int count, int index) {
+        for (int i = index; i < count - 1; i++)
+            relocate(slots[i + 1], &slots[i]);
+    }
+
+    // Moves slots [from, from + n) of one array to [to, to + n) of another
+    template<typename T, int N>
+    static void moveSlots(SlotArray<T, N>& source, int from, SlotArray<T, N>& target, int to, int n) {
+        for (int i = 0; i < n; i++)
+            relocate(source[from + i], &target[to + i]);
+    }
+
+    static void moveChildren(InnerNode* source, int from, InnerNode* target, int to, int n) {
+        std::copy(source->children + from, source->children + from + n, target->children + to);
+    }
+
+    // Adds key and the child to its right at index of an inner node
+    static void insertSeparator(InnerNode* inner, int index, const Key& key, void* right) {
+        openGap(inner->keys, inner->count, index);
+        new (&inner->keys[index]) Key(key);
+        std::copy_backward(inner->children + index + 1, inner->children + inner->count + 1,
+                           inner->children + inner->count + 2);
+        inner->children[index + 1] = right;
+        inner->count++;
+    }
+
+    // Removes key index of an inner node and the child to its right
+    static void eraseSeparator(InnerNode* inner, int index) {
+        inner->keys[index].~Key();
+        closeGap(inner->keys, inner->count, index);
+        std::copy(inner->children + index + 2, inner->children + inner->count + 1,
+                  inner->children + index + 1);
+        inner->count--;
+    }
+
+    // After an insert overfilled a leaf, moves its upper half to a new
+    // leaf to its right and adds that leaf to the parent, splitting inner
+    // nodes up the path as they overfill too. When appending past the
+    // largest key, only the new element moves, so ascending loads leave
+    // full nodes behind instead of half-full ones.
+    void splitLeaf(LeafNode* leaf, PathStep* path, bool append) {
+        LeafNode* right = createLeaf();
+        int keep = append ? leaf->count - 1 : leaf->count / 2;
+        int move = leaf->count - keep;
+        moveSlots(leaf->keys, keep, right->keys, 0, move);
+        moveSlots(leaf->items, keep, right->items, 0, move);
+        leaf->count = keep;
+        right->count = move;
+
+        right->prev = leaf;
+        right->next = leaf->next;
+        if (leaf->next) leaf->next->prev = right;
+        else lastLeaf = right;
+        leaf->next = right;
+
+        insertIntoParent(path, levels, leaf, right->keys[0], right, append);
+    }
+
+    // Links right next to left under the parent recorded at path[depth-1],
+    // with separator as the key between them. An overfull parent splits:
+    // its middle key moves up and the keys after it go to a new node.
+    // When appending, the new node takes only the last key, which keeps
+    // one key so that every node below the root has a sibling.
+    void insertIntoParent(PathStep* path, int depth, void* left, Key separator, void* right,
+                          bool append) {
+        while (depth > 0) {
+            InnerNode* parent = path[depth - 1].node;
+            insertSeparator(parent, path[depth - 1].index, separator, right);
+            if (parent->count <= SLOTS)
+                return;
+
+            InnerNode* sibling = createInner();
+            int middle = append ? parent->count - 2 : parent->count / 2;
+            int move = parent->count - middle - 1;
+            moveSlots(parent->keys, middle + 1, sibling->keys, 0, move);
+            moveChildren(parent, middle + 1, sibling, 0, move + 1);
+            sibling->count = move;
+            separator = std::move(parent->keys[middle]);
+            parent->keys[middle].~Key();
+            parent->count = middle;
+
+            left = parent;
+            right = sibling;
+            depth--;
+        }
+        growRoot(left, separator, right);
+    }
+
+    // Puts a new inner node with the two children above the root
+    void growRoot(void* left, const Key& separator, void* right) {
+        InnerNode* top = createInner();
+        new (&top->keys[0]) Key(separator);
+        top->children[0] = left;
+        top->children[1] = right;
+        top->count = 1;
+        root = top;
+        levels++;
+    }
+
+public:
+    // Bidirectional iterator over the leaf chain: a leaf and a slot in it.
+    // end() has no leaf; the iterator also remembers its map so that
+    // --end() can find the last element. IsConst selects const_iterator.
+    template<bool IsConst>
+    class basic_iterator {
+    private:
+        friend class btree_map;
+        friend class basic_iterator<true>;
+
+        typedef typename std::conditional<IsConst, const btree_map, btree_map>::type map_type;
+
+        LeafNode* leaf;
+        int index;
+        map_type* owner;
+
+        basic_iterator(LeafNode* l, int i, map_type* m) : leaf(l), index(i), owner(m) {}
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef typename btree_map::value_type value_type;
+        typedef typename btree_map::difference_type difference_type;
+        typedef typename std::conditional<IsConst, const value_type*, value_type*>::type pointer;
+        typedef typename std::conditional<IsConst, const value_type&, value_type&>::type reference;
+
+        basic_iterator() : leaf(nullptr), index(0), owner(nullptr) {}
+
+        // An iterator converts to a const_iterator, but not the other way
+        template<bool OtherConst,
+                 typename = typename std::enable_if<IsConst && !OtherConst>::type>
+        basic_iterator(const basic_iterator<OtherConst>& other)
+            : leaf(other.leaf), index(other.index), owner(other.owner) {}
+
+        // Dereference operators give the stored (key, value) pair
+        reference operator*() const {
+            if (!leaf) throw std::out_of_range("Dereferencing end iterator");
+            return leaf->items[index];
+        }
+
+        pointer operator->() const {
+            return &**this;
+        }
+
+        // Step to the next key; end() follows the largest one
+        basic_iterator& operator++() {
+            if (++index == leaf->count) {
+                leaf = leaf->next;
+                index = 0;
+            }
+            return *this;
+        }
+
+        basic_iterator operator++(int) {
+            basic_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        // Step to the previous key; --end() is the largest one
+        basic_iterator& operator--() {
+            if (!leaf) {
+                leaf = owner->lastLeaf;
+                index = leaf->count - 1;
+            } else if (index > 0) {
+                index--;
+            } else {
+                leaf = leaf->prev;
+                index = leaf->count - 1;
+            }
+            return *this;
+        }
+
+        basic_iterator operator--(int) {
+            basic_iterator old = *this;
+            --*this;
+            return old;
+        }
+
+        // Equality and inequality checks for iterators
+        bool operator==(const basic_iterator& other) const {
+            return leaf == other.leaf && index == other.index;
+        }
+
+        bool operator!=(const basic_iterator& other) const {
+            return !(*this == other);
+        }
+
+        // Shorthands for it->first and it->second
+        const Key& getKey() const {
+            return (**this).first;
+        }
+
+        typename std::conditional<IsConst, const Value&, Value&>::type getValue() const {
+            return (**this).second;
+        }
+    };
+
+    typedef basic_iterator<false> iterator;
+    typedef basic_iterator<true> const_iterator;
+
+    // Constructor initializes empty map
+    btree_map()
+        : leafPool(), innerPool(), root(nullptr), levels(0),
+          firstLeaf(nullptr), lastLeaf(nullptr), size_count(0) {}
+
+    // Copies every element, appending them in key order
+    btree_map(const btree_map& other)
+        : leafPool(), innerPool(), root(nullptr), levels(0),
+          firstLeaf(nullptr), lastLeaf(nullptr), size_count(0) {
+        try {
+            for (const_iterator it = other.begin(); it != other.end(); ++it)
+                insert(it->first, it->second);
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    // Takes over other's nodes and their storage; other is left empty
+    btree_map(btree_map&& other) noexcept
+        : leafPool(std::move(other.leafPool)), innerPool(std::move(other.innerPool)),
+          root(other.root), levels(other.levels), firstLeaf(other.firstLeaf),
+          lastLeaf(other.lastLeaf), size_count(other.size_count) {
+        other.root = nullptr;
+        other.levels = 0;
+        other.firstLeaf = other.lastLeaf = nullptr;
+        other.size_count = 0;
+    }
+
+    btree_map& operator=(const btree_map& other) {
+        if (this != &other) {
+            btree_map copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    btree_map& operator=(btree_map&& other) noexcept {
+        if (this != &other) {
+            clear();
+            swap(other);
+        }
+        return *this;
+    }
+
+    // Destructor cleans up all nodes
+    ~btree_map() { clear(); }
+
+    void swap(btree_map& other) {
+        std::swap(leafPool, other.leafPool);
+        std::swap(innerPool, other.innerPool);
+        std::swap(root, other.root);
+        std::swap(levels, other.levels);
+        std::swap(firstLeaf, other.firstLeaf);
+        std::swap(lastLeaf, other.lastLeaf);
+        std::swap(size_count, other.size_count);
+    }
+
+    // Removes every element and returns the node storage
+    void clear() {
+        if (root) destroySubtree(root, levels);
+        leafPool.release();
+        innerPool.release();
+        root = nullptr;
+        levels = 0;
+        firstLeaf = lastLeaf = nullptr;
+        size_count = 0;
+    }
+
+    // Inserts a key-value pair, or updates the value if the key exists.
+    // Returns the element and whether it is new.
+    std::pair<iterator, bool> insert(const Key& key, const Value& value) {
+        return assign(key, value);
+    }
+
+    std::pair<iterator, bool> insert(const Key& key, Value&& value) {
+        return assign(key, std::move(value));
+    }
+
+    // emplace(key, value) builds Value(value) in its leaf slot, and only
+    // if key is absent. Unlike avl_map, a B+ tree has no slot for the
+    // element until its key is known.
+    template<typename K, typename V>
+    std::pair<iterator, bool> emplace(K&& key, V&& value) {
+        return place(Key(std::forward<K>(key)), std::forward<V>(value));
+    }
+
+    // Any other form is a convenience wrapper: the (key, value) pair is
+    // built from args first, so the key can be found, and its value is
+    // then moved into the leaf if the key is absent
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        value_type item(std::forward<Args>(args)...);
+        return place(item.first, std::move(item.second));
+    }
+
+    // Builds Value(args...) in place only if key is absent
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        return place(key, std::forward<Args>(args)...);
+    }
+
+    // Removes key if present. A leaf that drops below half full takes an
+    // element from a sibling, or merges with one; merges can ripple up
+    // and shrink the tree by a level.
+    void erase(const Key& key) {
+        if (!root) return;
+        PathStep path[MAX_DEPTH];
+        LeafNode* leaf = findLeaf(key, path);
+        int index = lowerIndex(leaf->keys.data(), leaf->count, key);
+        if (index == leaf->count || key < leaf->keys[index])
+            return;   // Key not present
+
+        leaf->keys[index].~Key();
+        leaf->items[index].~value_type();
+        closeGap(leaf->keys, leaf->count, index);
+        closeGap(leaf->items, leaf->count, index);
+        leaf->count--;
+        size_count--;
+
+        if (levels == 0) {
+            if (leaf->count == 0) {
+                destroyLeaf(leaf);
+                root = nullptr;
+                firstLeaf = lastLeaf = nullptr;
+            }
+            return;
+        }
+        if (leaf->count < MIN_COUNT)
+            fixLeaf(leaf, path, levels);
+    }
+
+    // Returns an iterator pointing to the element if found
+    iterator find(const Key& key) {
+        std::pair<LeafNode*, int> at = findPosition(key);
+        return iterator(at.first, at.second, this);
+    }
+
+    const_iterator find(const Key& key) const {
+        std::pair<LeafNode*, int> at = findPosition(key);
+        return const_iterator(at.first, at.second, this);
+    }
+
+    // Returns iterator to the first key that is not less than key
+    iterator lower_bound(const Key& key) {
+        std::pair<LeafNode*, int> at = boundPosition(key, false);
+        return iterator(at.first, at.second, this);
+    }
+
+    const_iterator lower_bound(const Key& key) const {
+        std::pair<LeafNode*, int> at = boundPosition(key, false);
+        return const_iterator(at.first, at.second, this);
+    }
+
+    // Returns iterator to the first key that is greater than key
+    iterator upper_bound(const Key& key) {
+        std::pair<LeafNode*, int> at = boundPosition(key, true);
+        return iterator(at.first, at.second, this);
+    }
+
+    const_iterator upper_bound(const Key& key) const {
+        std::pair<LeafNode*, int> at = boundPosition(key, true);
+        return const_iterator(at.first, at.second, this);
+    }
+
+    // Returns the range of elements with this key (empty or one element)
+    std::pair<iterator, iterator> equal_range(const Key& key) {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const Key& key) const {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    // Calls fn(pair) for every element with lo <= key <= hi, in key order:
+    // one descent, then a walk along the leaves
+    template<typename Function>
+    void for_each_in_range(const Key& lo, const Key& hi, Function fn) {
+        for (iterator it = lower_bound(lo); it != end() && !(hi < it->first); ++it)
+            fn(*it);
+    }
+
+    template<typename Function>
+    void for_each_in_range(const Key& lo, const Key& hi, Function fn) const {
+        for (const_iterator it = lower_bound(lo); it != end() && !(hi < it->first); ++it)
+            fn(*it);
+    }
+
+    // Returns iterator to the smallest key (end() if empty)
+    iterator begin() {
+        return iterator(firstLeaf, 0, this);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(firstLeaf, 0, this);
+    }
+
+    const_iterator cbegin() const { return begin(); }
+
+    // Returns iterator representing "end" (no leaf)
+    iterator end() {
+        return iterator(nullptr, 0, this);
+    }
+
+    const_iterator end() const {
+        return const_iterator(nullptr, 0, this);
+    }
+
+    const_iterator cend() const { return end(); }
+
+    // Returns number of elements in the map
+    int size() const {
+        return size_count;
+    }
+
+    // Checks if the map is empty
+    bool empty() const {
+        return size_count == 0;
+    }
+
+private:
+    // Inserts or overwrites; V is const Value& or Value&&. One descent
+    // serves both outcomes: the leaf position either holds key or is
+    // where it goes.
+    template<typename V>
+    std::pair<iterator, bool> assign(const Key& key, V&& value) {
+        PathStep path[MAX_DEPTH];
+        int index;
+        LeafNode* leaf = leafForInsert(key, path, index);
+        if (index < leaf->count && !(key < leaf->keys[index])) {
+            leaf->items[index].second = std::forward<V>(value);
+            return std::make_pair(iterator(leaf, index, this), false);
+        }
+        return insertAt(leaf, index, path, key, std::forward<V>(value));
+    }
+
+    // Adds key with Value(args...) if absent
+    template<typename... Args>
+    std::pair<iterator, bool> place(const Key& key, Args&&... args) {
+        PathStep path[MAX_DEPTH];
+        int index;
+        LeafNode* leaf = leafForInsert(key, path, index);
+        if (index < leaf->count && !(key < leaf->keys[index]))
+            return std::make_pair(iterator(leaf, index, this), false);
+        return insertAt(leaf, index, path, key, std::forward<Args>(args)...);
+    }
+
+    // Descends to the leaf that holds or would hold key, recording the
+    // path for a split, and sets index to key's lower bound in it. An
+    // empty tree gets its first leaf.
+    LeafNode* leafForInsert(const Key& key, PathStep* path, int& index) {
+        if (!root) {
+            LeafNode* leaf = createLeaf();
+            root = firstLeaf = lastLeaf = leaf;
+        }
+        LeafNode* leaf = findLeaf(key, path);
+        index = lowerIndex(leaf->keys.data(), leaf->count, key);
+        return leaf;
+    }
+
+    // Puts key with Value(args...) at index of leaf, where path leads to
+    // it. The element goes into the leaf's spare slot; a leaf that is now
+    // overfull splits in two.
+    template<typename... Args>
+    std::pair<iterator, bool> insertAt(LeafNode* leaf, int index, PathStep* path,
+                                       const Key& key, Args&&... args) {
+        // Build the element first, so a throwing constructor leaves the
+        // leaf untouched
+        openGap(leaf->items, leaf->count, index);
+        try {
+            new (&leaf->items[index]) value_type(std::piecewise_construct,
+                                                 std::forward_as_tuple(key),
+                                                 std::forward_as_tuple(std::forward<Args>(args)...));
+        } catch (...) {
+            closeGapAfterFailedInsert(leaf->items, leaf->count, index);
+            if (size_count == 0) {
+                destroyLeaf(leaf);
+                root = firstLeaf = lastLeaf = nullptr;
+            }
+            throw;
+        }
+        openGap(leaf->keys, leaf->count, index);
+        new (&leaf->keys[index]) Key(key);
+        leaf->count++;
+        size_count++;
+
+        if (leaf->count <= SLOTS)
+            return std::make_pair(iterator(leaf, index, this), true);
+
+        splitLeaf(leaf, path, leaf == lastLeaf && index == leaf->count - 1);
+        // The new element may have moved to the right half
+        if (index >= leaf->count)
+            return std::make_pair(iterator(leaf->next, index - leaf->count, this), true);
+        return std::make_pair(iterator(leaf, index, this), true);
+    }
+
+    // Undoes openGap(slots, count, index) when nothing was put in the gap
+    template<typename T, int N>
+    static void closeGapAfterFailedInsert(SlotArray<T, N>& slots, int count, int index) {
+        for (int i = index; i < count; i++)
+            relocate(slots[i + 1], &slots[i]);
+    }
+
+    // Refills a leaf that fell below MIN_COUNT. path[depth-1] is its
+    // parent and which child it is.
+    void fixLeaf(LeafNode* leaf, PathStep* path, int depth) {
+        InnerNode* parent = path[depth - 1].node;
+        int index = path[depth - 1].index;
+        LeafNode* left = index > 0 ? static_cast<LeafNode*>(parent->children[index - 1]) : nullptr;
+        LeafNode* right = index < parent->count
+                          ? static_cast<LeafNode*>(parent->children[index + 1]) : nullptr;
+
+        if (left && left->count > MIN_COUNT) {
+            // Borrow the left sibling's last element
+            openGap(leaf->keys, leaf->count, 0);
+            openGap(leaf->items, leaf->count, 0);
+            moveSlots(left->keys, left->count - 1, leaf->keys, 0, 1);
+            moveSlots(left->items, left->count - 1, leaf->items, 0, 1);
+            left->count--;
+            leaf->count++;
+            parent->keys[index - 1] = leaf->keys[0];
+        } else if (right && right->count > MIN_COUNT) {
+            // Borrow the right sibling's first element
+            moveSlots(right->keys, 0, leaf->keys, leaf->count, 1);
+            moveSlots(right->items, 0, leaf->items, leaf->count, 1);
+            closeGap(right->keys, right->count, 0);
+            closeGap(right->items, right->count, 0);
+            right->count--;
+            leaf->count++;
+            parent->keys[index] = right->keys[0];
+        } else if (left) {
+            mergeLeaves(left, leaf, parent, index - 1);
+            fixInner(path, depth - 1);
+        } else {
+            mergeLeaves(leaf, right, parent, index);
+            fixInner(path, depth - 1);
+        }
+    }
+
+    // Moves every element of right into left, unchains right and removes
+    // it (and separator key index) from the parent
+    void mergeLeaves(LeafNode* left, LeafNode* right, InnerNode* parent, int index) {
+        moveSlots(right->keys, 0, left->keys, left->count, right->count);
+        moveSlots(right->items, 0, left->items, left->count, right->count);
+        left->count += right->count;
+        right->count = 0;
+
+        left->next = right->next;
+        if (right->next) right->next->prev = left;
+        else lastLeaf = left;
+
+        destroyLeaf(right);
+        eraseSeparator(parent, index);
+    }
+
+    // Refills the inner node path[depth].node after it lost a child, or
+    // removes the root level once the root has a single child left
+    void fixInner(PathStep* path, int depth) {
+        InnerNode* node = path[depth].node;
+        if (depth == 0) {
+            if (node->count == 0) {
+                root = node->children[0];
+                levels--;
+                destroyInner(node);
+            }
+            return;
+        }
+        if (node->count >= MIN_COUNT)
+            return;
+
+        InnerNode* parent = path[depth - 1].node;
+        int index = path[depth - 1].index;
+        InnerNode* left = index > 0 ? static_cast<InnerNode*>(parent->children[index - 1]) : nullptr;
+        InnerNode* right = index < parent->count
+                           ? static_cast<InnerNode*>(parent->children[index + 1]) : nullptr;
+
+        if (left && left->count > MIN_COUNT) {
+            // Rotate right: the parent's separator comes down in front,
+            // the left sibling's last key goes up in its place
+            openGap(node->keys, node->count, 0);
+            relocate(parent->keys[index - 1], &node->keys[0]);
+            std::copy_backward(node->children, node->children + node->count + 1,
+                               node->children + node->count + 2);
+            node->children[0] = left->children[left->count];
+            relocate(left->keys[left->count - 1], &parent->keys[index - 1]);
+            left->count--;
+            node->count++;
+        } else if (right && right->count > MIN_COUNT) {
+            // Rotate left: mirror image of the above
+            relocate(parent->keys[index], &node->keys[node->count]);
+            node->children[node->count + 1] = right->children[0];
+            relocate(right->keys[0], &parent->keys[index]);
+            closeGap(right->keys, right->count, 0);
+            std::copy(right->children + 1, right->children + right->count + 1, right->children);
+            right->count--;
+            node->count++;
+        } else {
+            // Merge with a sibling around the separator between them
+            InnerNode* into = left ? left : node;
+            InnerNode* from = left ? node : right;
+            int separator = left ? index - 1 : index;
+            relocate(parent->keys[separator], &into->keys[into->count]);
+            moveSlots(from->keys, 0, into->keys, into->count + 1, from->count);
+            moveChildren(from, 0, into, into->count + 1, from->count + 1);
+            into->count += from->count + 1;
+            from->count = 0;
+            destroyInner(from);
+
+            // The separator slot is already empty: close it by hand
+            closeGap(parent->keys, parent->count, separator);
+            std::copy(parent->children + separator + 2, parent->children + parent->count + 1,
+                      parent->children + separator + 1);
+            parent->count--;
+            fixInner(path, depth - 1);
+        }
+    }
+};
+
+#endif
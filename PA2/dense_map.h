@@ -0,0 +1,134 @@
+#ifndef DENSE_MAP_H
+#define DENSE_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// Read-only map from small non-negative int keys, such as 5-digit ZIP
+// codes, to values. A lookup does not search at all: the key itself
+// picks a bit in a presence bitmap, and the values of the present keys
+// are stored contiguously in key order, so the value for a key is at
+// the number of present keys below it.
+//
+// Each 64-bit word of the bitmap is stored next to the number of keys
+// below that word, so the index of a value is that count plus a
+// popcount within the word. For keys below 100000 the whole table of
+// words and counts is about 25 KB and stays in cache; a lookup then
+// costs at most one miss there and one in the values.
+template<typename Value>
+class dense_map {
+public:
+    typedef int key_type;
+    typedef Value mapped_type;
+
+private:
+    static const int BITS_PER_WORD = 64;
+
+    // Presence bits for keys [64 * i, 64 * i + 63], and the number of
+    // keys below 64 * i
+    struct Word {
+        std::uint64_t bits;
+        std::uint32_t rank;
+    };
+
+    int keyLimit;               // Keys must lie in [0, keyLimit)
+    std::vector<Word> words;
+    std::vector<Value> values;  // Values of the present keys, in key order
+
+    static int popcount(std::uint64_t bits) {
+#if defined(__GNUC__)
+        return __builtin_popcountll(bits);
+#else
+        int count = 0;
+        for (; bits; bits &= bits - 1) count++;
+        return count;
+#endif
+    }
+
+    // Position of a present key's value among all values
+    std::size_t slotOf(int key) const {
+        const Word& word = words[key / BITS_PER_WORD];
+        std::uint64_t bit = std::uint64_t(1) << (key % BITS_PER_WORD);
+        return word.rank + popcount(word.bits & (bit - 1));
+    }
+
+public:
+    dense_map() : keyLimit(0) {}
+
+    // Builds the table from [first, last), (key, value) pairs in any
+    // order. Throws std::invalid_argument if a key is outside
+    // [0, limit) or appears twice. O(n + limit).
+    template<typename ForwardIt>
+    dense_map(int limit, ForwardIt first, ForwardIt last)
+        : keyLimit(limit > 0 ? limit : 0),
+          words((keyLimit + BITS_PER_WORD - 1) / BITS_PER_WORD, Word()) {
+
+        // Pass 1: mark every key present
+        std::size_t count = 0;
+        for (ForwardIt it = first; it != last; ++it) {
+            int key = (*it).first;
+            if (key < 0 || key >= keyLimit)
+                throw std::invalid_argument("dense_map key out of range");
+            std::uint64_t bit = std::uint64_t(1) << (key % BITS_PER_WORD);
+            Word& word = words[key / BITS_PER_WORD];
+            if (word.bits & bit)
+                throw std::invalid_argument("dense_map key appears twice");
+            word.bits |= bit;
+            count++;
+        }
+
+        // Running counts give each key the position of its value
+        std::uint32_t rank = 0;
+        for (std::size_t i = 0; i < words.size(); i++) {
+            words[i].rank = rank;
+            rank += popcount(words[i].bits);
+        }
+
+        // Pass 2: put the values in key order
+        std::vector<ForwardIt> byRank(count);
+        for (ForwardIt it = first; it != last; ++it)
+            byRank[slotOf((*it).first)] = it;
+        values.reserve(count);
+        for (std::size_t i = 0; i < count; i++)
+            values.push_back((*byRank[i]).second);
+    }
+
+    // Returns the value for key, or nullptr if the key is not present
+    const Value* find(int key) const {
+        // Negative keys wrap around to large unsigned values
+        if (static_cast<unsigned>(key) >= static_cast<unsigned>(keyLimit))
+            return nullptr;
+        std::uint64_t bit = std::uint64_t(1) << (key % BITS_PER_WORD);
+        if (!(words[key / BITS_PER_WORD].bits & bit))
+            return nullptr;
+        return &values[slotOf(key)];
+    }
+
+    bool contains(int key) const {
+        return find(key) != nullptr;
+    }
+
+    // Returns the value for key, or throws std::out_of_range
+    const Value& at(int key) const {
+        const Value* value = find(key);
+        if (!value) throw std::out_of_range("Key not found in dense_map");
+        return *value;
+    }
+
+    int size() const {
+        return static_cast<int>(values.size());
+    }
+
+    bool empty() const {
+        return values.empty();
+    }
+
+    // Keys must be less than this
+    int key_limit() const {
+        return keyLimit;
+    }
+};
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef FROZEN_MAP_H
+#define FROZEN_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Read-only sorted index for maps that stop changing once they are
+// loaded, such as the ZIP code table. Build one with avl_map::freeze(),
+// or directly from (key, value) pairs in strictly increasing key order.
+//
+// The keys are stored in Eytzinger order: the implicit binary search
+// tree is laid out level by level, as in a binary heap, so the children
+// of slot k are slots 2k and 2k+1. The first levels of every search hit
+// the same few cache lines, and the slots a search can visit four levels
+// down are adjacent, so they can be prefetched together. The search
+// loop only computes the next slot from a comparison and never branches
+// on it. Values sit in a separate array in the same order, so searching
+// reads nothing but keys.
+template<typename Key, typename Value>
+class frozen_map {
+public:
+    typedef Key key_type;
+    typedef Value mapped_type;
+
+private:
+    static const std::size_t CACHE_LINE = 64;
+    // Keys per cache line; the 16 possible slots four levels below slot
+    // k, for int keys, are slots 16k to 16k + 15
+    static const std::size_t KEYS_PER_LINE = sizeof(Key) < CACHE_LINE ? CACHE_LINE / sizeof(Key) : 1;
+
+    std::vector<Key> keyStorage;    // Key slots, with padding for alignment
+    std::size_t keyOffset;          // Index of slot 0 in keyStorage
+    std::vector<Value> values;      // values[k - 1] belongs to key slot k
+    std::size_t count;
+
+    const Key* keys() const {
+        return keyStorage.data() + keyOffset;
+    }
+
+    static void prefetch(const void* address) {
+#if defined(__GNUC__)
+        __builtin_prefetch(address);
+#else
+        (void)address;
+#endif
+    }
+
+    // Walks down the implicit tree and returns the slot of the first key
+    // that is not less than key, or 0 if every key is less.
+    std::size_t lowerBoundSlot(const Key& key) const {
+        const Key* slots = keys();
+        std::size_t k = 1;
+        while (k <= count) {
+            // In the last levels the slots four levels down are past the
+            // end, and even forming that address would be undefined, so
+            // the prefetch stops there. The test depends only on k and is
+            // predicted right at every level but those few.
+            std::size_t ahead = k * KEYS_PER_LINE;
+            if (ahead <= count)
+                prefetch(slots + ahead);
+            k = 2 * k + (slots[k] < key);
+        }
+        // Each step right appended a 1 bit to k and each step left a 0.
+        // The answer is the last slot where the search went left, so drop
+        // the trailing 1s and then that 0.
+#if defined(__GNUC__)
+        return k >> __builtin_ffsll(~static_cast<unsigned long long>(k));
+#else
+        while (k & 1) k >>= 1;
+        return k >> 1;
+#endif
+    }
+
+    // Sets slotRank[k] to the sorted position of the key that belongs in
+    // slot k: an in-order walk of the implicit tree visits slots in key
+    // order.
+    static void assignRanks(std::vector<std::size_t>& slotRank, std::size_t n) {
+        std::size_t rank = 0;
+        std::size_t k = 1;
+        // Iterative in-order walk: go left as far as possible, visit, then
+        // take one step right
+        std::vector<std::size_t> stack;
+        while (k <= n || !stack.empty()) {
+            while (k <= n) {
+                stack.push_back(k);
+                k = 2 * k;
+            }
+            k = stack.back();
+            stack.pop_back();
+            slotRank[k] = rank++;
+            k = 2 * k + 1;
+        }
+    }
+
+public:
+    frozen_map() : keyOffset(0), count(0) {}
+
+    // Builds the index from [first, last), (key, value) pairs whose keys
+    // must be strictly increasing; throws std::invalid_argument if they
+    // are not. O(n).
+    template<typename ForwardIt>
+    frozen_map(ForwardIt first, ForwardIt last) : keyOffset(0), count(0) {
+        std::vector<ForwardIt> sorted;
+        for (ForwardIt it = first; it != last; ++it) {
+            if (!sorted.empty() && !((*sorted.back()).first < (*it).first))
+                throw std::invalid_argument("frozen_map keys must be strictly increasing");
+            sorted.push_back(it);
+        }
+        count = sorted.size();
+        if (count == 0) return;
+
+        std::vector<std::size_t> slotRank(count + 1);
+        assignRanks(slotRank, count);
+
+        // Slot 0 is never searched; it only gives the array the 1-based
+        // indexing. Slack in front lets slot 0 start on a cache line, so
+        // that each group of KEYS_PER_LINE slots shares one line.
+        std::size_t slack = CACHE_LINE / sizeof(Key) + 1;
+        keyStorage.assign(count + 1 + slack, (*first).first);
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(keyStorage.data());
+        std::size_t misalignment = address % CACHE_LINE;
+        if (misalignment != 0 && (CACHE_LINE - misalignment) % sizeof(Key) == 0)
+            keyOffset = (CACHE_LINE - misalignment) / sizeof(Key);
+
+        values.reserve(count);
+        for (std::size_t k = 1; k <= count; k++) {
+            keyStorage[keyOffset + k] = (*sorted[slotRank[k]]).first;
+            values.push_back((*sorted[slotRank[k]]).second);
+        }
+    }
+
+    // Copies would need their keys realigned, so the index can only be
+    // moved; moving a vector keeps its buffer and so its alignment.
+    frozen_map(const frozen_map&) = delete;
+    frozen_map& operator=(const frozen_map&) = delete;
+    frozen_map(frozen_map&& other) noexcept
+        : keyStorage(std::move(other.keyStorage)), keyOffset(other.keyOffset),
+          values(std::move(other.values)), count(other.count) {
+        other.keyOffset = 0;
+        other.count = 0;
+    }
+
+    frozen_map& operator=(frozen_map&& other) noexcept {
+        if (this != &other) {
+            keyStorage = std::move(other.keyStorage);
+            values = std::move(other.values);
+            keyOffset = other.keyOffset;
+            count = other.count;
+            other.keyStorage.clear();
+            other.values.clear();
+            other.keyOffset = 0;
+            other.count = 0;
+        }
+        return *this;
+    }
+
+    // Returns the value for key, or nullptr if the key is not present
+    const Value* find(const Key& key) const {
+        std::size_t k = lowerBoundSlot(key);
+        if (k == 0 || key < keys()[k])
+            return nullptr;
+        return &values[k - 1];
+    }
+
+    bool contains(const Key& key) const {
+        return find(key) != nullptr;
+    }
+
+    // Returns the value for key, or throws std::out_of_range
+    const Value& at(const Key& key) const {
+        const Value* value = find(key);
+        if (!value) throw std::out_of_range("Key not found in frozen_map");
+        return *value;
+    }
+
+    int size() const {
+        return static_cast<int>(count);
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+};
+
+#endif
@@ -6,7 +6,11 @@
 #include <chrono>
 #include <random>
 #include <algorithm>
+#include <utility>
 #include "avl_map.h"
+#include "btree_map.h"
+#include "dense_map.h"
+#include "frozen_map.h"
 #include "USCity.h"
 #include "CSVParser.h"
 
@@ -19,6 +23,8 @@ using namespace std;
  * - a custom avl_map<int, USCity>
  * - a standard STL map<int, USCity>
  * It also stores all ZIP codes into a std::list for later random selection.
+ * The rows are collected first and the avl_map is built from them in one
+ * pass; the file is sorted by ZIP code, so no rebalancing is needed.
  */
 bool loadZipCodeData(const string& filename, avl_map<int, USCity>& avl_cities,
                      map<int, USCity>& std_cities, list<int>& zipCodes) {
@@ -32,6 +38,7 @@ bool loadZipCodeData(const string& filename, avl_map<int, USCity>& avl_cities,
     string line;
     getline(file, line); // Skip header line
     int count = 0;
+    vector<pair<int, USCity> > rows;
 
     // Read file line by line
     while (getline(file, line)) {
@@ -53,15 +60,21 @@ bool loadZipCodeData(const string& filename, avl_map<int, USCity>& avl_cities,
         string timezone = fields.size() > 7 ? fields[7] : "";
         int population = fields.size() > 8 ? CSVParser::toInt(fields[8]) : 0;
 
-        // Create a USCity object and insert into both maps
+        // Create a USCity object; std::map gets a copy and the row for
+        // avl_map takes the original
         USCity cityData(city, state_id, state_name, county, timezone, lat, lng, population);
-        avl_cities.insert(zipCode, cityData);
         std_cities[zipCode] = cityData;
+        rows.push_back(make_pair(zipCode, std::move(cityData)));
         zipCodes.push_back(zipCode);
         count++;
     }
 
     file.close();
+
+    // Sorted input links straight into a balanced tree; unsorted input
+    // is sorted first
+    avl_cities = avl_map<int, USCity>::build_from_sorted(make_move_iterator(rows.begin()),
+                                                         make_move_iterator(rows.end()));
     cout << "Loaded " << count << " ZIP codes successfully." << endl;
     return true;
 }
@@ -87,51 +100,137 @@ vector<int> selectRandomZipCodes(const list<int>& zipCodes, int count) {
     return selected;
 }
 
+/*
+ * Function: drawRandomZipCodes
+ * ----------------------------
+ * Returns count ZIP codes drawn at random, with repetition, from the
+ * loaded ones: a stream of lookups spread over the whole map.
+ */
+vector<int> drawRandomZipCodes(const list<int>& zipCodes, int count) {
+    vector<int> allZips(zipCodes.begin(), zipCodes.end());
+    vector<int> drawn;
+    if (allZips.empty()) return drawn;
+
+    random_device rd;
+    mt19937 gen(rd());
+    uniform_int_distribution<size_t> pick(0, allZips.size() - 1);
+
+    drawn.reserve(count);
+    for (int i = 0; i < count; i++)
+        drawn.push_back(allZips[pick(gen)]);
+    return drawn;
+}
+
+// Timed passes over the lookup stream per map; the fastest one is
+// reported, so a pass slowed by the rest of the system does not count
+const int LOOKUP_PASSES = 5;
+
+/*
+ * Function: timeLookups
+ * ---------------------
+ * Looks up every probe ZIP in one map, LOOKUP_PASSES times, and returns
+ * the time per lookup of the fastest pass in nanoseconds. found is set to
+ * the number of probes that were present.
+ */
+template<typename MapType>
+double timeLookups(const MapType& cities, const vector<int>& probeZips, int& found) {
+    double best = 0;
+    for (int pass = 0; pass < LOOKUP_PASSES; pass++) {
+        auto start = chrono::high_resolution_clock::now();
+        found = 0;
+        for (int zip : probeZips) {
+            auto it = cities.find(zip);
+            if (it != cities.end()) found++;
+        }
+        auto end = chrono::high_resolution_clock::now();
+        double ns = chrono::duration<double, nano>(end - start).count() / max<size_t>(probeZips.size(), 1);
+        if (pass == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+// The read-only indexes, frozen_map and dense_map, return a pointer to
+// the value from find() rather than an iterator
+template<typename IndexType>
+double timeIndexLookups(const IndexType& cities, const vector<int>& probeZips, int& found) {
+    double best = 0;
+    for (int pass = 0; pass < LOOKUP_PASSES; pass++) {
+        auto start = chrono::high_resolution_clock::now();
+        found = 0;
+        for (int zip : probeZips) {
+            if (cities.find(zip)) found++;
+        }
+        auto end = chrono::high_resolution_clock::now();
+        double ns = chrono::duration<double, nano>(end - start).count() / max<size_t>(probeZips.size(), 1);
+        if (pass == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
 /*
  * Function: benchmarkLookups
  * --------------------------
  * Measures lookup performance between:
  * - avl_map (your custom AVL implementation)
  * - std::map (C++ STL Red-Black Tree)
- * Uses chrono for timing.
+ * - btree_map (B+ tree with cache-line sized nodes)
+ * - frozen_map (read-only Eytzinger index from avl_map::freeze())
+ * - dense_map (table indexed directly by ZIP code)
+ * Each map looks up the same stream of random ZIPs; times are per lookup,
+ * the best of LOOKUP_PASSES passes. Uses chrono for timing.
  */
-void benchmarkLookups(avl_map<int, USCity>& avl_cities, map<int, USCity>& std_cities,
-                      const vector<int>& testZips) {
+void benchmarkLookups(const avl_map<int, USCity>& avl_cities, const map<int, USCity>& std_cities,
+                      const btree_map<int, USCity>& btree_cities,
+                      const frozen_map<int, USCity>& frozen_cities,
+                      const dense_map<USCity>& dense_cities, const vector<int>& probeZips) {
 
     cout << "\n=== Performance Benchmark ===" << endl;
-    cout << "Testing with " << testZips.size() << " random ZIP codes\n" << endl;
+    cout << "Testing with " << probeZips.size() << " random lookups, best of "
+         << LOOKUP_PASSES << " passes\n" << endl;
 
     // Measure AVL lookup performance
-    auto start = chrono::high_resolution_clock::now();
     int avl_found = 0;
-    for (int zip : testZips) {
-        auto it = avl_cities.find(zip);
-        if (it != avl_cities.end()) avl_found++;
-    }
-    auto end = chrono::high_resolution_clock::now();
-    auto avl_duration = chrono::duration_cast<chrono::microseconds>(end - start);
+    double avl_time = timeLookups(avl_cities, probeZips, avl_found);
 
     cout << "AVL Map Results:" << endl;
-    cout << "  Time: " << avl_duration.count() << " microseconds" << endl;
-    cout << "  Found: " << avl_found << " / " << testZips.size() << endl;
+    cout << "  Time: " << avl_time << " ns/lookup" << endl;
+    cout << "  Found: " << avl_found << " / " << probeZips.size() << endl;
 
     // Measure STL map lookup performance
-    start = chrono::high_resolution_clock::now();
     int std_found = 0;
-    for (int zip : testZips) {
-        auto it = std_cities.find(zip);
-        if (it != std_cities.end()) std_found++;
-    }
-    end = chrono::high_resolution_clock::now();
-    auto std_duration = chrono::duration_cast<chrono::microseconds>(end - start);
+    double std_time = timeLookups(std_cities, probeZips, std_found);
 
     cout << "\nSTL Map Results:" << endl;
-    cout << "  Time: " << std_duration.count() << " microseconds" << endl;
-    cout << "  Found: " << std_found << " / " << testZips.size() << endl;
+    cout << "  Time: " << std_time << " ns/lookup" << endl;
+    cout << "  Found: " << std_found << " / " << probeZips.size() << endl;
+
+    // Measure B-tree lookup performance
+    int btree_found = 0;
+    double btree_time = timeLookups(btree_cities, probeZips, btree_found);
+
+    cout << "\nB-Tree Map Results:" << endl;
+    cout << "  Time: " << btree_time << " ns/lookup" << endl;
+    cout << "  Found: " << btree_found << " / " << probeZips.size() << endl;
+
+    // Measure frozen index lookup performance
+    int frozen_found = 0;
+    double frozen_time = timeIndexLookups(frozen_cities, probeZips, frozen_found);
+
+    cout << "\nFrozen Map Results:" << endl;
+    cout << "  Time: " << frozen_time << " ns/lookup" << endl;
+    cout << "  Found: " << frozen_found << " / " << probeZips.size() << endl;
+
+    // Measure direct-indexed table lookup performance
+    int dense_found = 0;
+    double dense_time = timeIndexLookups(dense_cities, probeZips, dense_found);
+
+    cout << "\nDense Map Results:" << endl;
+    cout << "  Time: " << dense_time << " ns/lookup" << endl;
+    cout << "  Found: " << dense_found << " / " << probeZips.size() << endl;
 
     // Compare performance ratios
     cout << "\n=== Performance Comparison ===" << endl;
-    double ratio = static_cast<double>(avl_duration.count()) / std_duration.count();
+    double ratio = avl_time / max(std_time, 1e-9);
     cout << "AVL Map / STL Map ratio: " << ratio << "x" << endl;
 
     if (ratio < 1.0) {
@@ -141,6 +240,148 @@ void benchmarkLookups(avl_map<int, USCity>& avl_cities, map<int, USCity>& std_ci
     } else {
         cout << "Both performed similarly." << endl;
     }
+
+    cout << "B-Tree Map / STL Map ratio: "
+         << btree_time / max(std_time, 1e-9) << "x" << endl;
+    cout << "Frozen Map / STL Map ratio: "
+         << frozen_time / max(std_time, 1e-9) << "x" << endl;
+    cout << "Frozen Map / AVL Map ratio: "
+         << frozen_time / max(avl_time, 1e-9) << "x" << endl;
+    cout << "Dense Map / STL Map ratio: "
+         << dense_time / max(std_time, 1e-9) << "x" << endl;
+    cout << "Dense Map / AVL Map ratio: "
+         << dense_time / max(avl_time, 1e-9) << "x" << endl;
+}
+
+/*
+ * Function: benchmarkScans
+ * ------------------------
+ * Times one full in-order pass over each map, summing populations
+ * so the traversal cannot be optimized away.
+ */
+void benchmarkScans(const avl_map<int, USCity>& avl_cities, const map<int, USCity>& std_cities,
+                    const btree_map<int, USCity>& btree_cities) {
+    cout << "\n=== Full Scan Benchmark ===" << endl;
+
+    auto start = chrono::high_resolution_clock::now();
+    long long avl_total = 0;
+    for (const auto& entry : avl_cities)
+        avl_total += entry.second.getPopulation();
+    auto end = chrono::high_resolution_clock::now();
+    auto avl_duration = chrono::duration_cast<chrono::microseconds>(end - start);
+
+    start = chrono::high_resolution_clock::now();
+    long long std_total = 0;
+    for (const auto& entry : std_cities)
+        std_total += entry.second.getPopulation();
+    end = chrono::high_resolution_clock::now();
+    auto std_duration = chrono::duration_cast<chrono::microseconds>(end - start);
+
+    start = chrono::high_resolution_clock::now();
+    long long btree_total = 0;
+    for (const auto& entry : btree_cities)
+        btree_total += entry.second.getPopulation();
+    end = chrono::high_resolution_clock::now();
+    auto btree_duration = chrono::duration_cast<chrono::microseconds>(end - start);
+
+    cout << "AVL Map: " << avl_duration.count() << " microseconds (total population "
+         << avl_total << ")" << endl;
+    cout << "STL Map: " << std_duration.count() << " microseconds (total population "
+         << std_total << ")" << endl;
+    cout << "B-Tree Map: " << btree_duration.count() << " microseconds (total population "
+         << btree_total << ")" << endl;
+}
+
+/*
+ * Function: timeLoadAndLookups
+ * ----------------------------
+ * Copies the loaded cities into a fresh map of the given type, then looks
+ * up the test ZIPs in it. Prints the time per insert and per lookup.
+ */
+template<typename MapType>
+void timeLoadAndLookups(const string& label, const avl_map<int, USCity>& avl_cities,
+                        const vector<int>& testZips) {
+    MapType cities;
+
+    auto start = chrono::high_resolution_clock::now();
+    for (const auto& entry : avl_cities)
+        cities.insert(entry.first, entry.second);
+    auto end = chrono::high_resolution_clock::now();
+    double load_ns = chrono::duration<double, nano>(end - start).count() / cities.size();
+
+    int found = 0;
+    start = chrono::high_resolution_clock::now();
+    for (int zip : testZips) {
+        if (cities.find(zip) != cities.end()) found++;
+    }
+    end = chrono::high_resolution_clock::now();
+    double find_ns = chrono::duration<double, nano>(end - start).count() / testZips.size();
+
+    cout << "  " << label << load_ns << " ns/insert, " << find_ns << " ns/lookup ("
+         << found << " found)" << endl;
+}
+
+/*
+ * Function: benchmarkLoads
+ * ------------------------
+ * Inserts the same ZIP data one key at a time into avl_map with its
+ * default slab allocator, avl_map with one heap allocation per node, and
+ * btree_map, then times the same lookups in each.
+ */
+void benchmarkLoads(const avl_map<int, USCity>& avl_cities, const vector<int>& testZips) {
+    if (avl_cities.empty() || testZips.empty()) return;
+    cout << "\n=== Load Benchmark ===" << endl;
+    timeLoadAndLookups<avl_map<int, USCity, heap_allocator> >("AVL, heap node per insert: ",
+                                                              avl_cities, testZips);
+    timeLoadAndLookups<avl_map<int, USCity> >("AVL, slab allocator:       ", avl_cities, testZips);
+    timeLoadAndLookups<btree_map<int, USCity> >("B-tree:                    ", avl_cities, testZips);
+
+    // The same data again, built in one pass from sorted input
+    auto start = chrono::high_resolution_clock::now();
+    avl_map<int, USCity> built = avl_map<int, USCity>::build_from_sorted(avl_cities.begin(),
+                                                                          avl_cities.end());
+    auto end = chrono::high_resolution_clock::now();
+    cout << "  AVL bulk build from sorted: "
+         << chrono::duration<double, nano>(end - start).count() / built.size()
+         << " ns/element" << endl;
+}
+
+/*
+ * Function: runRangeQuery
+ * -----------------------
+ * Counts the ZIP codes in [lo, hi] and their total population, using
+ * avl_map::for_each_in_range and a lower_bound/upper_bound walk over
+ * std::map, and times both.
+ */
+void runRangeQuery(const avl_map<int, USCity>& avl_cities, const map<int, USCity>& std_cities,
+                   int lo, int hi) {
+    cout << "\n=== Range Query: ZIP " << lo << " to " << hi << " ===" << endl;
+
+    auto start = chrono::high_resolution_clock::now();
+    int avl_count = 0;
+    long long avl_population = 0;
+    avl_cities.for_each_in_range(lo, hi, [&](const pair<const int, USCity>& entry) {
+        avl_count++;
+        avl_population += entry.second.getPopulation();
+    });
+    auto end = chrono::high_resolution_clock::now();
+    auto avl_duration = chrono::duration_cast<chrono::microseconds>(end - start);
+
+    start = chrono::high_resolution_clock::now();
+    int std_count = 0;
+    long long std_population = 0;
+    auto last = std_cities.upper_bound(hi);
+    for (auto it = std_cities.lower_bound(lo); it != last; ++it) {
+        std_count++;
+        std_population += it->second.getPopulation();
+    }
+    end = chrono::high_resolution_clock::now();
+    auto std_duration = chrono::duration_cast<chrono::microseconds>(end - start);
+
+    cout << "AVL Map: " << avl_count << " ZIP codes, population " << avl_population
+         << " (" << avl_duration.count() << " microseconds)" << endl;
+    cout << "STL Map: " << std_count << " ZIP codes, population " << std_population
+         << " (" << std_duration.count() << " microseconds)" << endl;
 }
 
 /*
@@ -165,7 +406,7 @@ void testAVLOperations() {
 
     // Test find() function
     auto it = test_map.find(30);
-    if (it != test_map.end()) cout << "Found 30: " << *it << endl;
+    if (it != test_map.end()) cout << "Found 30: " << it->second << endl;
 
     // Test erase() function
     cout << "Erasing key 20..." << endl;
@@ -183,8 +424,9 @@ void testAVLOperations() {
  * The main function ties everything together:
  * 1. Tests basic AVL functionality.
  * 2. Loads real ZIP code data from a CSV file.
- * 3. Benchmarks lookup performance against std::map.
- * 4. Displays one example lookup result.
+ * 3. Benchmarks lookup and full-scan performance against std::map
+ *    and btree_map, and lookups in a frozen_map and a dense_map.
+ * 4. Displays one example lookup result and one range query.
  */
 int main(int argc, char* argv[]) {
     cout << "AVL Map vs STL Map Performance Comparison" << endl;
@@ -206,9 +448,32 @@ int main(int argc, char* argv[]) {
     if (!loadZipCodeData(filename, avl_cities, std_cities, zipCodes))
         return 1;
 
+    // The B-tree gets a copy of the same data, in key order
+    btree_map<int, USCity> btree_cities;
+    for (const auto& entry : avl_cities)
+        btree_cities.insert(entry.first, entry.second);
+
+    // Lookups only from here on, so freeze a read-only index as well
+    frozen_map<int, USCity> frozen_cities = avl_cities.freeze();
+
+    // ZIP codes have five digits, so they can index a table directly. The
+    // keys are sorted, so those in range are one stretch of the AVL map;
+    // dense_map would reject any others a malformed file brought in.
+    const int ZIP_LIMIT = 100000;
+    dense_map<USCity> dense_cities(ZIP_LIMIT, avl_cities.lower_bound(0),
+                                   avl_cities.lower_bound(ZIP_LIMIT));
+    int skippedZips = avl_cities.size() - dense_cities.size();
+    if (skippedZips > 0) {
+        cout << "Dense Map skipped " << skippedZips << " ZIP codes outside [0, "
+             << ZIP_LIMIT << ")" << endl;
+    }
+
     // Step 4: Display data sizes for confirmation
     cout << "\nAVL Map size: " << avl_cities.size() << endl;
     cout << "STL Map size: " << std_cities.size() << endl;
+    cout << "B-Tree Map size: " << btree_cities.size() << endl;
+    cout << "Frozen Map size: " << frozen_cities.size() << endl;
+    cout << "Dense Map size: " << dense_cities.size() << endl;
     cout << "ZIP codes list size: " << zipCodes.size() << endl;
 
     // Step 5: Randomly pick ZIPs for benchmarking
@@ -217,7 +482,11 @@ int main(int argc, char* argv[]) {
     vector<int> testZips = selectRandomZipCodes(zipCodes, testCount);
 
     // Step 6: Run benchmark
-    benchmarkLookups(avl_cities, std_cities, testZips);
+    const int PROBE_COUNT = 1000000;
+    vector<int> probeZips = drawRandomZipCodes(zipCodes, PROBE_COUNT);
+    benchmarkLookups(avl_cities, std_cities, btree_cities, frozen_cities, dense_cities, probeZips);
+    benchmarkScans(avl_cities, std_cities, btree_cities);
+    benchmarkLoads(avl_cities, testZips);
 
     // Step 7: Display one sample lookup
     if (!testZips.empty()) {
@@ -228,10 +497,13 @@ int main(int argc, char* argv[]) {
         auto it = avl_cities.find(sampleZip);
         if (it != avl_cities.end()) {
             cout << "Found in AVL Map: ";
-            (*it).display();  // Call USCity::display() to show info
+            it->second.display();  // Call USCity::display() to show info
         }
     }
 
+    // Step 8: Range query over the Washington ZIP codes
+    runRangeQuery(avl_cities, std_cities, 98000, 99499);
+
     cout << "\nProgram completed successfully!" << endl;
     return 0;
 }
@@ -0,0 +1,153 @@
+#ifndef SLAB_ALLOCATOR_H
+#define SLAB_ALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Node allocators for avl_map. An allocator hands out raw, suitably
+// aligned storage for one N at a time; avl_map constructs and destroys
+// the nodes in it.
+//
+//   void* allocate();          storage for one N
+//   void deallocate(void* p);  return storage obtained from allocate()
+//   void reserve(size_t n);    hint that n nodes are about to be allocated
+//   void release();            called once every node has been destroyed
+
+// Slab allocator: nodes are carved out of contiguous blocks, so nodes
+// inserted together sit next to each other in memory. Blocks start at
+// FIRST_BLOCK_NODES nodes and double until they reach MAX_BLOCK_BYTES,
+// so large nodes such as B-tree leaves get fewer per block. Erased nodes
+// are recycled through a free list in O(1), and release() frees the
+// blocks themselves, which is O(number of blocks). reserve() makes one
+// block big enough for a whole bulk load.
+template<typename N>
+class slab_allocator {
+private:
+    static const std::size_t FIRST_BLOCK_NODES = 16;
+    static const std::size_t MAX_BLOCK_BYTES = 1 << 20;
+
+    // A free slot holds the link to the next free slot
+    union Slot {
+        Slot* nextFree;
+        typename std::aligned_storage<sizeof(N), alignof(N)>::type storage;
+    };
+
+    // Blocks are chained through a header placed before their slots
+    struct Block {
+        Block* next;
+        std::size_t capacity;
+
+        Slot* slots() {
+            return reinterpret_cast<Slot*>(reinterpret_cast<char*>(this) + headerBytes());
+        }
+
+        static std::size_t headerBytes() {
+            return (sizeof(Block) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+        }
+    };
+
+    Block* blocks;          // Most recent block first
+    Slot* freeList;         // Slots returned by deallocate()
+    std::size_t usedInBlock; // Slots handed out from blocks->slots()
+
+    void addBlock(std::size_t capacity) {
+        Block* block = static_cast<Block*>(
+            ::operator new(Block::headerBytes() + capacity * sizeof(Slot)));
+        block->next = blocks;
+        block->capacity = capacity;
+        blocks = block;
+        usedInBlock = 0;
+    }
+
+public:
+    slab_allocator() : blocks(nullptr), freeList(nullptr), usedInBlock(0) {}
+
+    ~slab_allocator() {
+        release();
+    }
+
+    slab_allocator(const slab_allocator&) = delete;
+    slab_allocator& operator=(const slab_allocator&) = delete;
+
+    slab_allocator(slab_allocator&& other) noexcept
+        : blocks(other.blocks), freeList(other.freeList), usedInBlock(other.usedInBlock) {
+        other.blocks = nullptr;
+        other.freeList = nullptr;
+        other.usedInBlock = 0;
+    }
+
+    slab_allocator& operator=(slab_allocator&& other) noexcept {
+        if (this != &other) {
+            release();
+            std::swap(blocks, other.blocks);
+            std::swap(freeList, other.freeList);
+            std::swap(usedInBlock, other.usedInBlock);
+        }
+        return *this;
+    }
+
+    void* allocate() {
+        // Reuse an erased node first
+        if (freeList) {
+            Slot* slot = freeList;
+            freeList = slot->nextFree;
+            return slot;
+        }
+
+        // Start a new block, twice the size of the last one
+        if (!blocks || usedInBlock == blocks->capacity) {
+            std::size_t capacity = blocks ? blocks->capacity * 2 : FIRST_BLOCK_NODES;
+            std::size_t limit = MAX_BLOCK_BYTES / sizeof(Slot);
+            if (capacity > limit) capacity = limit > FIRST_BLOCK_NODES ? limit : FIRST_BLOCK_NODES;
+            addBlock(capacity);
+        }
+        return &blocks->slots()[usedInBlock++];
+    }
+
+    // Makes sure the current block has room for count more nodes, so that
+    // a bulk load fills one contiguous block in order. allocate() still
+    // hands out free-list slots first, and any slots left over in the old
+    // block go unused until release().
+    void reserve(std::size_t count) {
+        if (blocks && blocks->capacity - usedInBlock >= count)
+            return;
+        addBlock(count > FIRST_BLOCK_NODES ? count : FIRST_BLOCK_NODES);
+    }
+
+    void deallocate(void* p) {
+        Slot* slot = static_cast<Slot*>(p);
+        slot->nextFree = freeList;
+        freeList = slot;
+    }
+
+    void release() {
+        while (blocks) {
+            Block* block = blocks;
+            blocks = blocks->next;
+            ::operator delete(block);
+        }
+        freeList = nullptr;
+        usedInBlock = 0;
+    }
+};
+
+// One heap allocation per node, as avl_map did before slabs.
+template<typename N>
+class heap_allocator {
+public:
+    void* allocate() {
+        return ::operator new(sizeof(N));
+    }
+
+    void deallocate(void* p) {
+        ::operator delete(p);
+    }
+
+    void reserve(std::size_t) {}
+
+    void release() {}
+};
+
+#endif
@@ -1,5 +1,12 @@
 #include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
 #include "avl_map.h"
+#include "btree_map.h"
+#include "dense_map.h"
+#include "frozen_map.h"
 
 using namespace std;
 
@@ -32,11 +39,11 @@ void testSimpleInsertions() {
 
     // Verify that all inserted keys exist
     auto it = tree.find(10);
-    if (it != tree.end()) cout << "Found 10: " << *it << endl;
+    if (it != tree.end()) cout << "Found 10: " << it->second << endl;
     it = tree.find(20);
-    if (it != tree.end()) cout << "Found 20: " << *it << endl;
+    if (it != tree.end()) cout << "Found 20: " << it->second << endl;
     it = tree.find(30);
-    if (it != tree.end()) cout << "Found 30: " << *it << endl;
+    if (it != tree.end()) cout << "Found 30: " << it->second << endl;
 
     cout << "✓ Simple insertions test passed" << endl;
 }
@@ -65,7 +72,7 @@ void testLLRotation() {
     for (int key : {10, 20, 30}) {
         auto it = tree.find(key);
         if (it != tree.end())
-            cout << "Found " << key << ": " << *it << endl;
+            cout << "Found " << key << ": " << it->second << endl;
         else
             cout << "ERROR: Could not find " << key << endl;
     }
@@ -95,7 +102,7 @@ void testRRRotation() {
     for (int key : {10, 20, 30}) {
         auto it = tree.find(key);
         if (it != tree.end())
-            cout << "Found " << key << ": " << *it << endl;
+            cout << "Found " << key << ": " << it->second << endl;
         else
             cout << "ERROR: Could not find " << key << endl;
     }
@@ -124,7 +131,7 @@ void testLRRotation() {
 
     for (int key : {10, 20, 30}) {
         auto it = tree.find(key);
-        if (it != tree.end()) cout << "Found " << key << ": " << *it << endl;
+        if (it != tree.end()) cout << "Found " << key << ": " << it->second << endl;
     }
     cout << "✓ LR rotation test passed" << endl;
 }
@@ -151,7 +158,7 @@ void testRLRotation() {
 
     for (int key : {10, 20, 30}) {
         auto it = tree.find(key);
-        if (it != tree.end()) cout << "Found " << key << ": " << *it << endl;
+        if (it != tree.end()) cout << "Found " << key << ": " << it->second << endl;
     }
     cout << "✓ RL rotation test passed" << endl;
 }
@@ -231,8 +238,8 @@ void testLargeDataset() {
 
     for (int key : test_keys) {
         auto it = tree.find(key);
-        if (it != tree.end() && *it == key * 10)
-            cout << "  ✓ Found " << key << " -> " << *it << endl;
+        if (it != tree.end() && it->second == key * 10)
+            cout << "  ✓ Found " << key << " -> " << it->second << endl;
         else
             cout << "  ERROR: Failed to find " << key << endl;
     }
@@ -253,21 +260,613 @@ void testUpdateValue() {
     cout << "Inserted 10 -> 'Original'" << endl;
 
     auto it = tree.find(10);
-    if (it != tree.end()) cout << "Current value: " << *it << endl;
+    if (it != tree.end()) cout << "Current value: " << it->second << endl;
 
     cout << "Updating 10 -> 'Updated'" << endl;
     tree.insert(10, "Updated");
 
     it = tree.find(10);
     if (it != tree.end()) {
-        cout << "New value: " << *it << endl;
-        if (*it == "Updated")
+        cout << "New value: " << it->second << endl;
+        if (it->second == "Updated")
             cout << "✓ Update test passed" << endl;
         else
             cout << "ERROR: Value not updated!" << endl;
     }
 }
 
+/*
+ * Test: Random Operations
+ * -----------------------
+ * Applies a long random mix of inserts, updates and erases to both the
+ * AVL tree and std::map, then checks that every key in the range is found
+ * (or not) with the same value in both. Exercises every rebalancing path
+ * of the iterative insert and erase.
+ */
+void testRandomOperations() {
+    printTestHeader("Random Operations vs std::map");
+    avl_map<int, int> tree;
+    map<int, int> reference;
+    mt19937 gen(12345);
+    uniform_int_distribution<> key_dist(0, 1999);
+    uniform_int_distribution<> op_dist(0, 2);
+
+    int operations = 50000;
+    cout << "Applying " << operations << " random inserts and erases..." << endl;
+    for (int i = 0; i < operations; i++) {
+        int key = key_dist(gen);
+        if (op_dist(gen) == 0) {
+            tree.erase(key);
+            reference.erase(key);
+        } else {
+            tree.insert(key, i);
+            reference[key] = i;
+        }
+    }
+
+    cout << "Tree size: " << tree.size() << " (std::map: " << reference.size() << ")" << endl;
+    if (tree.size() != static_cast<int>(reference.size())) {
+        cout << "ERROR: Sizes differ!" << endl;
+        return;
+    }
+
+    int mismatches = 0;
+    for (int key = -1; key <= 2000; key++) {
+        auto it = tree.find(key);
+        auto ref = reference.find(key);
+        bool inTree = it != tree.end();
+        bool inReference = ref != reference.end();
+        if (inTree != inReference || (inTree && it->second != ref->second))
+            mismatches++;
+    }
+    if (mismatches == 0)
+        cout << "✓ Random operations test passed" << endl;
+    else
+        cout << "ERROR: " << mismatches << " keys differ from std::map!" << endl;
+}
+
+/*
+ * Test: Iteration
+ * ---------------
+ * Walks the tree forwards from begin() and backwards from end() after
+ * random inserts and erases, comparing every (key, value) pair with
+ * std::map. Also writes a value through an iterator.
+ */
+void testIteration() {
+    printTestHeader("In-order Iteration");
+    avl_map<int, int> tree;
+    map<int, int> reference;
+    mt19937 gen(777);
+    uniform_int_distribution<> key_dist(0, 4999);
+
+    if (tree.begin() != tree.end()) {
+        cout << "ERROR: begin() != end() on an empty tree!" << endl;
+        return;
+    }
+
+    for (int i = 0; i < 20000; i++) {
+        int key = key_dist(gen);
+        if (i % 3 == 0) {
+            tree.erase(key);
+            reference.erase(key);
+        } else {
+            tree.insert(key, i);
+            reference[key] = i;
+        }
+    }
+
+    // Forwards, including post-increment and the pair-style access
+    auto ref = reference.begin();
+    int visited = 0;
+    for (auto it = tree.begin(); it != tree.end(); it++, ref++, visited++) {
+        if (ref == reference.end() || it->first != ref->first || (*it).second != ref->second) {
+            cout << "ERROR: Forward traversal differs at position " << visited << endl;
+            return;
+        }
+    }
+    cout << "Visited " << visited << " keys forwards" << endl;
+
+    // Backwards through a const_iterator, starting from --end()
+    const avl_map<int, int>& constTree = tree;
+    auto rref = reference.rbegin();
+    int back = 0;
+    for (avl_map<int, int>::const_iterator it = constTree.end(); it != constTree.begin(); rref++, back++) {
+        --it;
+        if (it.getKey() != rref->first || it.getValue() != rref->second) {
+            cout << "ERROR: Backward traversal differs at position " << back << endl;
+            return;
+        }
+    }
+    cout << "Visited " << back << " keys backwards" << endl;
+
+    // Writing through an iterator changes the stored value
+    auto it = tree.begin();
+    it->second = -1;
+    if (tree.find(it->first)->second != -1) {
+        cout << "ERROR: Write through iterator was lost!" << endl;
+        return;
+    }
+
+    if (visited == static_cast<int>(reference.size()) && back == visited)
+        cout << "✓ Iteration test passed" << endl;
+    else
+        cout << "ERROR: Traversal visited the wrong number of keys!" << endl;
+}
+
+/*
+ * Test: Range Queries
+ * -------------------
+ * Compares lower_bound, upper_bound, equal_range and for_each_in_range
+ * with std::map on a sparse key set, including bounds below, between,
+ * on and above the stored keys.
+ */
+void testRangeQueries() {
+    printTestHeader("Range Queries");
+    avl_map<int, int> tree;
+    map<int, int> reference;
+    mt19937 gen(2024);
+    uniform_int_distribution<> key_dist(0, 9999);
+
+    for (int i = 0; i < 3000; i++) {
+        int key = key_dist(gen);
+        tree.insert(key, i);
+        reference[key] = i;
+    }
+
+    // Bounds for every probe key, stored or not
+    for (int key = -5; key <= 10005; key++) {
+        auto lower = tree.lower_bound(key);
+        auto refLower = reference.lower_bound(key);
+        auto upper = tree.upper_bound(key);
+        auto refUpper = reference.upper_bound(key);
+        bool lowerOk = (lower == tree.end()) ? refLower == reference.end()
+                                             : refLower != reference.end() && lower->first == refLower->first;
+        bool upperOk = (upper == tree.end()) ? refUpper == reference.end()
+                                             : refUpper != reference.end() && upper->first == refUpper->first;
+        if (!lowerOk || !upperOk) {
+            cout << "ERROR: Bounds differ from std::map for key " << key << endl;
+            return;
+        }
+    }
+    cout << "lower_bound and upper_bound agree with std::map" << endl;
+
+    auto stored = tree.equal_range(reference.begin()->first);
+    auto missing = tree.equal_range(-1);
+    if (stored.first == stored.second || ++stored.first != stored.second ||
+        missing.first != missing.second) {
+        cout << "ERROR: equal_range returned the wrong range!" << endl;
+        return;
+    }
+
+    // Inclusive ranges of many widths, including empty and reversed ones
+    for (int i = 0; i < 500; i++) {
+        int lo = key_dist(gen) - 50;
+        int hi = lo + (i % 50) * (i % 7) - 10;
+        vector<int> visited;
+        tree.for_each_in_range(lo, hi, [&visited](const pair<const int, int>& entry) {
+            visited.push_back(entry.first);
+        });
+
+        vector<int> expected;
+        if (lo <= hi) {
+            for (auto it = reference.lower_bound(lo); it != reference.upper_bound(hi); ++it)
+                expected.push_back(it->first);
+        }
+        if (visited != expected) {
+            cout << "ERROR: for_each_in_range(" << lo << ", " << hi << ") visited "
+                 << visited.size() << " keys, expected " << expected.size() << endl;
+            return;
+        }
+    }
+    cout << "✓ Range query test passed" << endl;
+}
+
+/*
+ * Test: Node Allocators
+ * ---------------------
+ * Runs the same erase/reinsert/clear sequence on a slab-allocated and a
+ * heap-allocated tree. Erased nodes are recycled by the slab allocator,
+ * and a cleared tree must be usable again.
+ */
+template<template<typename> class Allocator>
+bool checkAllocatorRoundTrip() {
+    avl_map<int, string, Allocator> tree;
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 2000; i++)
+            tree.insert(i, to_string(i));
+        for (int i = 0; i < 2000; i += 2)
+            tree.erase(i);
+        for (int i = 0; i < 2000; i += 2)
+            tree.insert(i, to_string(i * 2));
+
+        if (tree.size() != 2000) return false;
+        for (int i = 0; i < 2000; i++) {
+            auto it = tree.find(i);
+            if (it == tree.end() || it->second != to_string(i % 2 ? i : i * 2))
+                return false;
+        }
+        tree.clear();
+        if (!tree.empty() || tree.begin() != tree.end()) return false;
+    }
+    return true;
+}
+
+void testNodeAllocators() {
+    printTestHeader("Node Allocators");
+    bool slabOk = checkAllocatorRoundTrip<slab_allocator>();
+    bool heapOk = checkAllocatorRoundTrip<heap_allocator>();
+    cout << "Slab allocator: " << (slabOk ? "ok" : "FAILED") << endl;
+    cout << "Heap allocator: " << (heapOk ? "ok" : "FAILED") << endl;
+    if (slabOk && heapOk)
+        cout << "✓ Node allocator test passed" << endl;
+    else
+        cout << "ERROR: Allocator round trip failed!" << endl;
+}
+
+/*
+ * Value type that counts how often it is copied, for checking that
+ * moves and in-place construction really avoid copies.
+ */
+struct CopyCounter {
+    static int copies;
+    static int moves;
+    string text;
+
+    CopyCounter() {}
+    explicit CopyCounter(const string& t) : text(t) {}
+    CopyCounter(const string& a, const string& b) : text(a + b) {}
+    CopyCounter(const CopyCounter& other) : text(other.text) { copies++; }
+    CopyCounter(CopyCounter&& other) : text(std::move(other.text)) { moves++; }
+    CopyCounter& operator=(const CopyCounter& other) { text = other.text; copies++; return *this; }
+    CopyCounter& operator=(CopyCounter&& other) { text = std::move(other.text); moves++; return *this; }
+};
+
+int CopyCounter::copies = 0;
+int CopyCounter::moves = 0;
+
+/*
+ * Test: Moves, Emplace and Copies
+ * -------------------------------
+ * rvalue insert, emplace and try_emplace must not copy the value, and
+ * emplace/try_emplace must leave an existing key alone. A copied map must
+ * be equal to and independent of the original; a moved-from map is empty.
+ */
+void testMoveAndCopy() {
+    printTestHeader("Moves, Emplace and Copies");
+    avl_map<int, CopyCounter> tree;
+    CopyCounter::copies = 0;
+
+    for (int i = 0; i < 100; i++)
+        tree.insert(i, CopyCounter(to_string(i)));
+    tree.insert(5, CopyCounter("five"));                    // Overwrite by move
+    auto emplaced = tree.emplace(100, CopyCounter("hundred"));
+    auto tried = tree.try_emplace(101, "one", "-oh-one");   // Built in place
+    auto triedAgain = tree.try_emplace(101, "ignored");
+    auto emplacedAgain = tree.emplace(5, CopyCounter("ignored"));
+
+    if (CopyCounter::copies != 0) {
+        cout << "ERROR: " << CopyCounter::copies << " values were copied!" << endl;
+        return;
+    }
+    if (!emplaced.second || !tried.second || triedAgain.second || emplacedAgain.second ||
+        tree.find(5)->second.text != "five" || tree.find(101)->second.text != "one-oh-one" ||
+        triedAgain.first != tried.first || tree.size() != 102) {
+        cout << "ERROR: emplace/try_emplace returned the wrong result!" << endl;
+        return;
+    }
+    cout << "Inserted and emplaced 102 values without copying" << endl;
+
+    // Copies are deep and keep every element
+    avl_map<int, CopyCounter> copy(tree);
+    copy.insert(0, CopyCounter("changed"));
+    copy.erase(1);
+    bool sameAsBefore = tree.find(0)->second.text == "0" && tree.find(1) != tree.end();
+    avl_map<int, CopyCounter> assigned;
+    assigned.insert(-1, CopyCounter("old"));
+    assigned = tree;
+    bool equal = assigned.size() == tree.size() && assigned.find(-1) == assigned.end();
+    for (auto a = assigned.begin(), t = tree.begin(); equal && t != tree.end(); ++a, ++t)
+        equal = a->first == t->first && a->second.text == t->second.text;
+    if (!sameAsBefore || !equal || copy.size() != 101) {
+        cout << "ERROR: Copy is not independent or not equal!" << endl;
+        return;
+    }
+
+    // Moves hand over the nodes and empty the source
+    avl_map<int, CopyCounter> moved(std::move(assigned));
+    avl_map<int, CopyCounter> moveAssigned;
+    moveAssigned = std::move(copy);
+    if (!assigned.empty() || !copy.empty() || moved.size() != 102 || moveAssigned.size() != 101 ||
+        moved.find(101)->second.text != "one-oh-one") {
+        cout << "ERROR: Move did not transfer the elements!" << endl;
+        return;
+    }
+    assigned.insert(7, CopyCounter("reused"));   // A moved-from map is still usable
+    cout << "✓ Move and copy test passed" << endl;
+}
+
+/*
+ * Test: Bulk Build
+ * ----------------
+ * Builds trees from sorted, unsorted and duplicate-keyed input and
+ * compares them with std::map, then keeps inserting and erasing in a
+ * built tree to make sure it is a valid AVL tree.
+ */
+void testBulkBuild() {
+    printTestHeader("Bulk Build from Sorted Input");
+    mt19937 gen(99);
+
+    vector<pair<int, int> > sorted;
+    for (int i = 0; i < 5000; i++)
+        sorted.push_back(make_pair(i * 3, i));
+    avl_map<int, int> built = avl_map<int, int>::build_from_sorted(sorted.begin(), sorted.end());
+
+    // Unsorted input with repeated keys: the last value for a key wins
+    vector<pair<int, int> > unsorted;
+    map<int, int> reference;
+    uniform_int_distribution<> key_dist(0, 999);
+    for (int i = 0; i < 3000; i++) {
+        int key = key_dist(gen);
+        unsorted.push_back(make_pair(key, i));
+        reference[key] = i;
+    }
+    avl_map<int, int> fromUnsorted = avl_map<int, int>::build_from_sorted(unsorted.begin(), unsorted.end());
+
+    vector<pair<int, int> > none;
+    avl_map<int, int> empty = avl_map<int, int>::build_from_sorted(none.begin(), none.end());
+
+    bool sortedOk = built.size() == 5000;
+    int index = 0;
+    for (auto it = built.begin(); sortedOk && it != built.end(); ++it, ++index)
+        sortedOk = it->first == index * 3 && it->second == index;
+    bool unsortedOk = fromUnsorted.size() == static_cast<int>(reference.size());
+    auto ref = reference.begin();
+    for (auto it = fromUnsorted.begin(); unsortedOk && it != fromUnsorted.end(); ++it, ++ref)
+        unsortedOk = it->first == ref->first && it->second == ref->second;
+    if (!sortedOk || !unsortedOk || !empty.empty() || empty.begin() != empty.end()) {
+        cout << "ERROR: Built tree differs from its input!" << endl;
+        return;
+    }
+    cout << "Built 5000 sorted and " << fromUnsorted.size() << " deduplicated keys" << endl;
+
+    // Keep modifying the built tree; heights must be right for this to work
+    map<int, int> shadow(sorted.begin(), sorted.end());
+    uniform_int_distribution<> any_key(0, 15000);
+    for (int i = 0; i < 20000; i++) {
+        int key = any_key(gen);
+        if (i % 2) {
+            built.erase(key);
+            shadow.erase(key);
+        } else {
+            built.insert(key, -i);
+            shadow[key] = -i;
+        }
+    }
+    bool same = built.size() == static_cast<int>(shadow.size());
+    auto sh = shadow.begin();
+    for (auto it = built.begin(); same && it != built.end(); ++it, ++sh)
+        same = it->first == sh->first && it->second == sh->second;
+    if (same)
+        cout << "✓ Bulk build test passed" << endl;
+    else
+        cout << "ERROR: Built tree went wrong after further updates!" << endl;
+}
+
+/*
+ * Test: B-Tree Map
+ * ----------------
+ * btree_map has the same interface as avl_map. Applies a random mix of
+ * inserts and erases large enough to split and merge nodes on several
+ * levels, then compares lookups, bounds and both traversal directions
+ * with std::map, and finally erases everything. emplace(key, value) must
+ * build the value in its leaf slot and leave an existing key alone.
+ */
+void testBTreeMap() {
+    printTestHeader("B-Tree Map vs std::map");
+    btree_map<int, string> tree;
+    map<int, string> reference;
+    mt19937 gen(4242);
+    uniform_int_distribution<> key_dist(0, 49999);
+
+    for (int i = 0; i < 200000; i++) {
+        int key = key_dist(gen);
+        if (i % 3 == 0) {
+            tree.erase(key);
+            reference.erase(key);
+        } else {
+            tree.insert(key, to_string(i));
+            reference[key] = to_string(i);
+        }
+    }
+    cout << "Tree size: " << tree.size() << " (std::map: " << reference.size() << ")" << endl;
+
+    bool same = tree.size() == static_cast<int>(reference.size());
+    auto ref = reference.begin();
+    for (auto it = tree.begin(); same && it != tree.end(); ++it, ++ref)
+        same = it->first == ref->first && it->second == ref->second;
+    auto rref = reference.rbegin();
+    for (auto it = tree.end(); same && it != tree.begin(); ++rref) {
+        --it;
+        same = it.getKey() == rref->first;
+    }
+    for (int key = -1; same && key <= 50000; key += 7) {
+        auto it = tree.find(key);
+        auto lower = tree.lower_bound(key);
+        auto refLower = reference.lower_bound(key);
+        same = (it != tree.end()) == (reference.count(key) == 1) &&
+               (lower == tree.end() ? refLower == reference.end()
+                                    : refLower != reference.end() && lower->first == refLower->first);
+    }
+    if (!same) {
+        cout << "ERROR: B-tree differs from std::map!" << endl;
+        return;
+    }
+
+    btree_map<int, string> copy(tree);
+    for (auto& entry : reference)
+        tree.erase(entry.first);
+    if (!tree.empty() || tree.begin() != tree.end() || copy.size() != static_cast<int>(reference.size())) {
+        cout << "ERROR: Erasing every key left the B-tree inconsistent!" << endl;
+        return;
+    }
+
+    // Appending to a leaf with room moves no other element, so any move
+    // would be of the emplaced value itself
+    btree_map<int, CopyCounter> counters;
+    for (int i = 0; i < 3; i++)
+        counters.emplace(i, to_string(i));
+    CopyCounter::copies = CopyCounter::moves = 0;
+    auto emplaced = counters.emplace(3, "3");
+    auto emplacedAgain = counters.emplace(1, "ignored");
+    if (CopyCounter::copies != 0 || CopyCounter::moves != 0 || !emplaced.second ||
+        emplacedAgain.second || emplacedAgain.first->second.text != "1" || counters.size() != 4) {
+        cout << "ERROR: B-tree emplace copied or moved values, or replaced one!" << endl;
+        return;
+    }
+    cout << "✓ B-tree test passed" << endl;
+}
+
+/*
+ * Test: Frozen Map
+ * ----------------
+ * Freezes avl_maps of every size up to 70 and of 20,000 random keys, and
+ * checks that frozen_map finds exactly the keys of the tree with the same
+ * values, including keys below, between and above them. Also checks that
+ * a moved-from index is empty and that unsorted input is rejected.
+ */
+void testFrozenMap() {
+    printTestHeader("Frozen Map Lookups");
+
+    // Every size up to a few full levels, so the search ends on every
+    // kind of slot
+    for (int n = 0; n <= 70; n++) {
+        avl_map<int, int> tree;
+        for (int i = 0; i < n; i++)
+            tree.insert(i * 2, i * 10);
+        frozen_map<int, int> frozen = tree.freeze();
+        if (frozen.size() != n) {
+            cout << "ERROR: Frozen map of " << n << " keys has size " << frozen.size() << endl;
+            return;
+        }
+        for (int key = -1; key <= n * 2; key++) {
+            const int* value = frozen.find(key);
+            bool expected = key >= 0 && key % 2 == 0 && key < n * 2;
+            if ((value != nullptr) != expected || (value && *value != key * 5)) {
+                cout << "ERROR: Frozen map of " << n << " keys got key " << key << " wrong!" << endl;
+                return;
+            }
+        }
+    }
+
+    // Random keys against the AVL map they were frozen from
+    avl_map<int, string> tree;
+    mt19937 gen(777);
+    uniform_int_distribution<> key_dist(0, 99999);
+    for (int i = 0; i < 20000; i++) {
+        int key = key_dist(gen);
+        tree.insert(key, to_string(key));
+    }
+    frozen_map<int, string> frozen = tree.freeze();
+    cout << "Frozen " << frozen.size() << " keys" << endl;
+    for (int key = 0; key <= 99999; key++) {
+        const string* value = frozen.find(key);
+        bool present = tree.find(key) != tree.end();
+        if (present != frozen.contains(key) || (value && *value != to_string(key))) {
+            cout << "ERROR: Frozen map disagrees with avl_map on key " << key << endl;
+            return;
+        }
+    }
+
+    frozen_map<int, string> moved(std::move(frozen));
+    if (moved.size() != tree.size() || !frozen.empty() || frozen.find(tree.begin()->first)) {
+        cout << "ERROR: Moving the frozen map failed!" << endl;
+        return;
+    }
+
+    vector<pair<int, int> > unsorted = {{3, 0}, {1, 0}};
+    bool threw = false;
+    try {
+        frozen_map<int, int> bad(unsorted.begin(), unsorted.end());
+    } catch (const invalid_argument&) {
+        threw = true;
+    }
+    if (!threw) {
+        cout << "ERROR: Unsorted input was accepted!" << endl;
+        return;
+    }
+    cout << "✓ Frozen map test passed" << endl;
+}
+
+/*
+ * Test: Dense Map
+ * ---------------
+ * Builds dense_map from 30,000 random keys given in random order and
+ * checks every key from -1 to the limit against std::map. Also checks the
+ * keys at word and range edges, an empty table, and that out-of-range and
+ * repeated keys are rejected.
+ */
+void testDenseMap() {
+    printTestHeader("Dense Map Lookups");
+
+    // Random keys in random order, against std::map
+    map<int, string> reference;
+    vector<pair<int, string> > pairs;
+    mt19937 gen(2024);
+    uniform_int_distribution<> key_dist(0, 99999);
+    for (int i = 0; i < 30000; i++) {
+        int key = key_dist(gen);
+        if (reference.count(key)) continue;
+        reference[key] = to_string(key);
+        pairs.push_back(make_pair(key, to_string(key)));
+    }
+    dense_map<string> table(100000, pairs.begin(), pairs.end());
+    cout << "Table size: " << table.size() << " (std::map: " << reference.size() << ")" << endl;
+
+    if (table.size() != static_cast<int>(reference.size())) {
+        cout << "ERROR: Dense map has the wrong size!" << endl;
+        return;
+    }
+    for (int key = -1; key <= 100000; key++) {
+        const string* value = table.find(key);
+        bool present = reference.count(key) == 1;
+        if ((value != nullptr) != present || (value && *value != reference[key])) {
+            cout << "ERROR: Dense map disagrees with std::map on key " << key << endl;
+            return;
+        }
+    }
+
+    // Keys on both edges of the range, and a map with no keys at all
+    vector<pair<int, int> > edges = {{99999, 1}, {0, 2}, {63, 3}, {64, 4}};
+    dense_map<int> edgeTable(100000, edges.begin(), edges.end());
+    dense_map<int> emptyTable(100000, edges.end(), edges.end());
+    if (edgeTable.at(0) != 2 || edgeTable.at(63) != 3 || edgeTable.at(64) != 4 ||
+        edgeTable.at(99999) != 1 || edgeTable.contains(1) || !emptyTable.empty() ||
+        emptyTable.contains(0)) {
+        cout << "ERROR: Dense map edge keys are wrong!" << endl;
+        return;
+    }
+
+    // Out of range and repeated keys are rejected
+    int rejected = 0;
+    vector<pair<int, int> > tooLarge = {{100000, 0}};
+    vector<pair<int, int> > repeated = {{5, 0}, {5, 1}};
+    try {
+        dense_map<int> bad(100000, tooLarge.begin(), tooLarge.end());
+    } catch (const invalid_argument&) {
+        rejected++;
+    }
+    try {
+        dense_map<int> bad(100000, repeated.begin(), repeated.end());
+    } catch (const invalid_argument&) {
+        rejected++;
+    }
+    if (rejected != 2) {
+        cout << "ERROR: Invalid keys were accepted!" << endl;
+        return;
+    }
+    cout << "✓ Dense map test passed" << endl;
+}
+
 /*
  * Main test runner
  * ----------------
@@ -287,6 +886,15 @@ int main() {
         testDeletion();
         testUpdateValue();
         testLargeDataset();
+        testRandomOperations();
+        testIteration();
+        testRangeQueries();
+        testNodeAllocators();
+        testMoveAndCopy();
+        testBulkBuild();
+        testBTreeMap();
+        testFrozenMap();
+        testDenseMap();
 
         cout << "\n========================================" << endl;
         cout << "ALL TESTS PASSED! ✓" << endl;